@@ -51,6 +51,7 @@
 #include "directory.h"
 #include "filehdr.h"
 #include "filesys.h"
+#include "SwapManager.h"
 
 // Sectors containing the file headers for the bitmap of free sectors,
 // and the directory of files.  These file headers are placed in well-known 
@@ -98,6 +99,11 @@ FileSystem::FileSystem(bool format)
 	freeMap->Mark(DirectorySector);
     freeMap->Mark(PipeSector);
 
+    // The last SwapSectors sectors are the swap area of the virtual
+    // memory system (see vm/SwapManager.h); keep files out of them.
+	for (int i = 0; i < SwapSectors; i++)
+	    freeMap->Mark(SwapStartSector + i);
+
     // Second, allocate space for the data blocks containing the contents
     // of the directory and bitmap files.  There better be enough space!
 
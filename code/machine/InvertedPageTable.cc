@@ -0,0 +1,173 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-18 14:40:09
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-18 21:07:13
+ * @Description: 
+ */
+#include "InvertedPageTable.h"
+#include "debug.h"
+
+InvertedPageTable::InvertedPageTable(int bucketNums)
+{
+    ASSERT(bucketNums > 0);
+
+    this->bucketNums = bucketNums;
+    entryNums = 0;
+    freeList = NULL;
+    buckets = new InvertedPageEntry*[bucketNums];
+    for (int i = 0; i < bucketNums; i++)
+    {
+        buckets[i] = NULL;
+    }
+}
+
+InvertedPageTable::~InvertedPageTable()
+{
+    for (int i = 0; i < bucketNums; i++)
+    {
+        while (buckets[i] != NULL)
+        {
+            InvertedPageEntry* item = buckets[i];
+            buckets[i] = item->next;
+            delete item;
+        }
+    }
+    while (freeList != NULL)
+    {
+        InvertedPageEntry* item = freeList;
+        freeList = item->next;
+        delete item;
+    }
+    delete[] buckets;
+}
+
+int
+InvertedPageTable::hash(int asid, int vpn)
+{
+    unsigned int key = ((unsigned int)asid * 2654435761u) ^ (unsigned int)vpn;
+
+    return key % bucketNums;
+}
+
+InvertedPageEntry*
+InvertedPageTable::allocEntry()
+{
+    InvertedPageEntry* item = freeList;
+
+    if (item != NULL)
+    {
+        freeList = item->next;
+    }
+    else
+    {
+        item = new InvertedPageEntry;
+    }
+    return item;
+}
+
+void
+InvertedPageTable::freeEntry(InvertedPageEntry* item)
+{
+    item->next = freeList;
+    freeList = item;
+}
+
+TranslationEntry*
+InvertedPageTable::lookup(int asid, int vpn)
+{
+    for (InvertedPageEntry* item = buckets[hash(asid, vpn)]; item != NULL; item = item->next)
+    {
+        if (item->asid == asid && item->virtualPage == vpn)
+        {
+            return &item->entry;
+        }
+    }
+    return NULL;
+}
+
+TranslationEntry*
+InvertedPageTable::insert(int asid, int vpn)
+{
+    TranslationEntry* entry = lookup(asid, vpn);
+    if (entry != NULL)
+    {
+        return entry;
+    }
+
+    int bucket = hash(asid, vpn);
+    InvertedPageEntry* item = allocEntry();
+
+    item->asid = asid;
+    item->virtualPage = vpn;
+    item->entry.clear();
+    item->next = buckets[bucket];
+    buckets[bucket] = item;
+    entryNums++;
+
+    return &item->entry;
+}
+
+void
+InvertedPageTable::remove(int asid, int vpn)
+{
+    InvertedPageEntry** link = &buckets[hash(asid, vpn)];
+
+    for (; *link != NULL; link = &(*link)->next)
+    {
+        InvertedPageEntry* item = *link;
+        if (item->asid == asid && item->virtualPage == vpn)
+        {
+            *link = item->next;
+            freeEntry(item);
+            entryNums--;
+            return;
+        }
+    }
+}
+
+/**
+ * @description: 复制地址空间fromAsid的所有表项到toAsid。扫描整个哈希表，代价只和表项数量有关
+ * @param {int fromAsid, int toAsid} 
+ * @return: 
+ */
+void
+InvertedPageTable::copyAll(int fromAsid, int toAsid)
+{
+    ASSERT(fromAsid != toAsid);
+
+    for (int i = 0; i < bucketNums; i++)
+    {
+        for (InvertedPageEntry* item = buckets[i]; item != NULL; item = item->next)
+        {
+            if (item->asid == fromAsid)
+            {
+                //新插入的表项属于toAsid，之后被遍历到时会被跳过
+                *insert(toAsid, item->virtualPage) = item->entry;
+            }
+        }
+    }
+}
+
+void
+InvertedPageTable::removeAll(int asid)
+{
+    for (int i = 0; i < bucketNums; i++)
+    {
+        InvertedPageEntry** link = &buckets[i];
+        while (*link != NULL)
+        {
+            InvertedPageEntry* item = *link;
+            if (item->asid == asid)
+            {
+                *link = item->next;
+                freeEntry(item);
+                entryNums--;
+            }
+            else
+            {
+                link = &item->next;
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-18 14:22:51
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-18 21:07:13
+ * @Description: 全局的哈希倒排页表，只有在定义了INVERTED_PAGETABLE时使用。
+ *               所有地址空间的驻留页都记录在同一个以(ASID, vpn)为键的哈希表中，TLB缺失时由Machine::Translate查找。
+ *               表项只为在内存中的页存在，页表占用的内存只和物理内存大小(以及共享页的映射者数量)有关
+ */
+#ifndef INVERTEDPAGETABLE_H
+#define INVERTEDPAGETABLE_H
+
+#include "translate.h"
+
+class InvertedPageEntry
+{
+    public:
+        int asid;                       //地址空间号，即地址空间所属的线程号
+        int virtualPage;
+        TranslationEntry entry;
+        InvertedPageEntry* next;        //同一个哈希桶中的下一项
+};
+
+class InvertedPageTable
+{
+    public:
+        InvertedPageTable(int bucketNums);
+        ~InvertedPageTable();
+
+        TranslationEntry* lookup(int asid, int vpn);
+        TranslationEntry* insert(int asid, int vpn);    //(asid, vpn)已经存在时返回原来的表项
+        void remove(int asid, int vpn);
+
+        void copyAll(int fromAsid, int toAsid);         //fork时复制一个地址空间的所有表项
+        void removeAll(int asid);
+
+        int getEntryNums() {return entryNums;}
+
+    private:
+        int bucketNums;
+        int entryNums;
+        InvertedPageEntry** buckets;
+        InvertedPageEntry* freeList;    //回收的表项，避免频繁地分配和释放
+
+        int hash(int asid, int vpn);
+        InvertedPageEntry* allocEntry();
+        void freeEntry(InvertedPageEntry* item);
+};
+
+#endif	// INVERTEDPAGETABLE_H
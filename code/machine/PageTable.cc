@@ -0,0 +1,258 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-17 19:20:12
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-18 10:31:26
+ * @Description: 
+ */
+#include "PageTable.h"
+#include "debug.h"
+
+#ifdef INVERTED_PAGETABLE
+#include "main.h"
+
+static int
+swapSlotKey(PageSwapSlot* item)
+{
+    return item->virtualPage;
+}
+
+static unsigned
+swapSlotHash(int vpn)
+{
+    return (unsigned)vpn;
+}
+
+PageTable::PageTable(int asid, int pageNums)
+{
+    ASSERT(pageNums >= 0 && pageNums <= MaxVirtPages);
+
+    this->asid = asid;
+    numPages = pageNums;
+    swapSlotTable = new HashTable<int, PageSwapSlot*>(swapSlotKey, swapSlotHash);
+}
+
+PageTable::PageTable(int asid, PageTable* other)
+{
+    this->asid = asid;
+    numPages = other->numPages;
+    swapSlotTable = new HashTable<int, PageSwapSlot*>(swapSlotKey, swapSlotHash);
+
+    kernel->machine->invertedPageTable->copyAll(other->asid, asid);
+
+    HashIterator<int, PageSwapSlot*> iter(other->swapSlotTable);
+    for (; !iter.IsDone(); iter.Next())
+    {
+        setSwapSlot(iter.Item()->virtualPage, iter.Item()->slot);
+    }
+}
+
+PageTable::~PageTable()
+{
+    kernel->machine->invertedPageTable->removeAll(asid);
+
+    while (!swapSlotTable->IsEmpty())
+    {
+        HashIterator<int, PageSwapSlot*> iter(swapSlotTable);
+        delete swapSlotTable->Remove(iter.Item()->virtualPage);
+    }
+    delete swapSlotTable;
+}
+
+TranslationEntry*
+PageTable::lookup(int vpn)
+{
+    if (vpn < 0 || vpn >= numPages)
+    {
+        return NULL;
+    }
+    return kernel->machine->invertedPageTable->lookup(asid, vpn);
+}
+
+TranslationEntry*
+PageTable::getEntry(int vpn)
+{
+    if (vpn < 0 || vpn >= numPages)
+    {
+        return NULL;
+    }
+    return kernel->machine->invertedPageTable->insert(asid, vpn);
+}
+
+void
+PageTable::releaseEntry(int vpn)
+{
+    kernel->machine->invertedPageTable->remove(asid, vpn);
+}
+
+int
+PageTable::getSwapSlot(int vpn)
+{
+    PageSwapSlot* item;
+
+    return swapSlotTable->Find(vpn, &item) ? item->slot : -1;
+}
+
+void
+PageTable::setSwapSlot(int vpn, int slot)
+{
+    PageSwapSlot* item;
+
+    if (swapSlotTable->Find(vpn, &item))
+    {
+        if (slot == -1)
+        {
+            delete swapSlotTable->Remove(vpn);
+        }
+        else
+        {
+            item->slot = slot;
+        }
+    }
+    else if (slot != -1)
+    {
+        item = new PageSwapSlot;
+        item->virtualPage = vpn;
+        item->slot = slot;
+        swapSlotTable->Insert(item);
+    }
+}
+
+#else
+
+PageTable::PageTable(int asid, int pageNums)
+{
+    ASSERT(pageNums >= 0 && pageNums <= MaxVirtPages);
+
+    this->asid = asid;
+    numPages = pageNums;
+    tableNums = 0;
+    for (int i = 0; i < PageTableTopSize; i++)
+    {
+        topTable[i] = NULL;
+    }
+}
+
+PageTable::PageTable(int asid, PageTable* other)
+{
+    this->asid = asid;
+    numPages = other->numPages;
+    tableNums = other->tableNums;
+    for (int i = 0; i < PageTableTopSize; i++)
+    {
+        topTable[i] = NULL;
+        if (other->topTable[i] == NULL)
+        {
+            continue;
+        }
+
+        topTable[i] = new PageTableLeaf*[PageTableMidSize];
+        for (int j = 0; j < PageTableMidSize; j++)
+        {
+            topTable[i][j] = NULL;
+            if (other->topTable[i][j] != NULL)
+            {
+                topTable[i][j] = new PageTableLeaf(*other->topTable[i][j]);
+            }
+        }
+    }
+}
+
+PageTable::~PageTable()
+{
+    for (int i = 0; i < PageTableTopSize; i++)
+    {
+        if (topTable[i] != NULL)
+        {
+            for (int j = 0; j < PageTableMidSize; j++)
+            {
+                delete topTable[i][j];
+            }
+            delete[] topTable[i];
+        }
+    }
+}
+
+/**
+ * @description: 找到vpn所在的叶子表
+ * @param {int vpn, bool alloc} alloc为TRUE时分配缺少的二级表和叶子表
+ * @return: 叶子表，vpn越界或者表不存在时返回NULL
+ */
+PageTableLeaf*
+PageTable::getLeaf(int vpn, bool alloc)
+{
+    if (vpn < 0 || vpn >= numPages)
+    {
+        return NULL;
+    }
+
+    int top = vpn >> (PageTableMidBits + PageTableLeafBits);
+    int mid = (vpn >> PageTableLeafBits) & (PageTableMidSize - 1);
+
+    if (topTable[top] == NULL)
+    {
+        if (!alloc)
+        {
+            return NULL;
+        }
+        topTable[top] = new PageTableLeaf*[PageTableMidSize];
+        for (int j = 0; j < PageTableMidSize; j++)
+        {
+            topTable[top][j] = NULL;
+        }
+        tableNums++;
+    }
+
+    PageTableLeaf* leaf = topTable[top][mid];
+    if (leaf == NULL && alloc)
+    {
+        leaf = new PageTableLeaf;
+        int base = vpn & ~(PageTableLeafSize - 1);
+        for (int i = 0; i < PageTableLeafSize; i++)
+        {
+            leaf->swapSlots[i] = -1;
+        }
+        topTable[top][mid] = leaf;
+        tableNums++;
+        DEBUG(dbgAddr, "Allocate page table for pages " << base << " - " << base + PageTableLeafSize - 1);
+    }
+
+    return leaf;
+}
+
+TranslationEntry*
+PageTable::lookup(int vpn)
+{
+    PageTableLeaf* leaf = getLeaf(vpn, FALSE);
+
+    return (leaf == NULL) ? NULL : &leaf->entries[vpn & (PageTableLeafSize - 1)];
+}
+
+TranslationEntry*
+PageTable::getEntry(int vpn)
+{
+    PageTableLeaf* leaf = getLeaf(vpn, TRUE);
+
+    return (leaf == NULL) ? NULL : &leaf->entries[vpn & (PageTableLeafSize - 1)];
+}
+
+int
+PageTable::getSwapSlot(int vpn)
+{
+    PageTableLeaf* leaf = getLeaf(vpn, FALSE);
+
+    return (leaf == NULL) ? -1 : leaf->swapSlots[vpn & (PageTableLeafSize - 1)];
+}
+
+void
+PageTable::setSwapSlot(int vpn, int slot)
+{
+    PageTableLeaf* leaf = getLeaf(vpn, slot != -1);
+
+    if (leaf != NULL)
+    {
+        leaf->swapSlots[vpn & (PageTableLeafSize - 1)] = slot;
+    }
+}
+
+#endif // INVERTED_PAGETABLE
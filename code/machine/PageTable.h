@@ -0,0 +1,96 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-17 19:05:37
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-18 21:07:13
+ * @Description: 每个地址空间一个三级页表，由Machine::Translate在TLB缺失时遍历。
+ *               虚拟页号从高到低分为一级表下标、二级表下标和叶子表下标，二级表和叶子表只在第一次被访问时分配，
+ *               页表占用的内存只和实际用到的虚拟页数量有关。叶子表同时记录不在内存中的页所在的交换槽
+ *               定义了INVERTED_PAGETABLE时，PageTable只是全局倒排页表(见InvertedPageTable.h)中属于该地址空间的部分，
+ *               页被换出后表项就被删除，交换槽另外记录在一个只包含被换出页的哈希表中
+ */
+#ifndef PAGETABLE_H
+#define PAGETABLE_H
+
+#include "translate.h"
+
+#define PageTableLeafBits 7
+#define PageTableMidBits 7
+#define PageTableTopBits 6
+
+#define PageTableLeafSize (1 << PageTableLeafBits)
+#define PageTableMidSize (1 << PageTableMidBits)
+#define PageTableTopSize (1 << PageTableTopBits)
+
+#define MaxVirtPages (1 << (PageTableTopBits + PageTableMidBits + PageTableLeafBits))
+
+#ifdef INVERTED_PAGETABLE
+#include "hash.h"
+
+class PageSwapSlot
+{
+    public:
+        int virtualPage;
+        int slot;
+};
+
+class PageTable
+{
+    public:
+        PageTable(int asid, int pageNums);
+        PageTable(int asid, PageTable* other);  //复制other在倒排页表中的所有表项
+        ~PageTable();                           //删除该地址空间在倒排页表中的所有表项
+
+        TranslationEntry* lookup(int vpn);      //只查找不插入，不在倒排页表中时返回NULL
+        TranslationEntry* getEntry(int vpn);    //不在倒排页表中时插入一个无效的表项
+        void releaseEntry(int vpn);             //页被换出后从倒排页表中删除表项
+
+        int getSwapSlot(int vpn);
+        void setSwapSlot(int vpn, int slot);
+
+        int getNumPages() {return numPages;}
+
+    private:
+        int asid;
+        int numPages;
+        HashTable<int, PageSwapSlot*>* swapSlotTable;
+};
+
+#else
+
+class PageTableLeaf
+{
+    public:
+        TranslationEntry entries[PageTableLeafSize];
+        int swapSlots[PageTableLeafSize];   //不在内存中的页所在的交换槽，-1表示从可执行文件读入
+};
+
+class PageTable
+{
+    public:
+        PageTable(int asid, int pageNums);
+        PageTable(int asid, PageTable* other);  //复制other中已经分配的所有表
+        ~PageTable();
+
+        TranslationEntry* lookup(int vpn);  //只查找不分配，叶子表不存在时返回NULL
+        TranslationEntry* getEntry(int vpn);//叶子表不存在时分配
+        void releaseEntry(int vpn) {}       //多级页表中无效的表项不需要删除
+
+        int getSwapSlot(int vpn);
+        void setSwapSlot(int vpn, int slot);
+
+        int getNumPages() {return numPages;}
+        int getTableNums() {return tableNums;}
+
+    private:
+        int asid;
+        int numPages;                       //合法的虚拟页号为[0, numPages)
+        int tableNums;                      //已分配的二级表和叶子表数量
+        PageTableLeaf** topTable[PageTableTopSize];
+
+        PageTableLeaf* getLeaf(int vpn, bool alloc);
+};
+
+#endif // INVERTED_PAGETABLE
+
+#endif	// PAGETABLE_H
@@ -0,0 +1,59 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-22 10:02:37
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-22 15:18:45
+ * @Description:
+ */
+#include "ReferenceTrace.h"
+#include "debug.h"
+#include "sysdep.h"
+
+ReferenceTrace::ReferenceTrace(char* fileName)
+{
+    unsigned int magic = ReferenceTraceMagic;
+
+    fileId = OpenForWrite(fileName);
+    WriteFile(fileId, (char*)&magic, sizeof(magic));
+    buffer = new unsigned int[TraceBufferRecords * 2];
+    bufferedNums = 0;
+    recordNums = 0;
+}
+
+ReferenceTrace::~ReferenceTrace()
+{
+    flush();
+    Close(fileId);
+    delete[] buffer;
+    DEBUG(dbgAddr, "Reference trace: " << recordNums << " references");
+}
+
+void
+ReferenceTrace::record(int asid, int vpn, bool writing, int tick)
+{
+    unsigned int word = ((unsigned int)vpn & TraceVpnMask) | ((unsigned int)asid << TraceAsidShift);
+
+    if (writing)
+    {
+        word |= TraceWriteBit;
+    }
+    buffer[bufferedNums * 2] = word;
+    buffer[bufferedNums * 2 + 1] = (unsigned int)tick;
+    bufferedNums++;
+    recordNums++;
+
+    if (bufferedNums == TraceBufferRecords)
+    {
+        flush();
+    }
+}
+
+void
+ReferenceTrace::flush()
+{
+    if (bufferedNums > 0)
+    {
+        WriteFile(fileId, (char*)buffer, bufferedNums * 2 * sizeof(unsigned int));
+        bufferedNums = 0;
+    }
+}
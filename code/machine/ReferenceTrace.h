@@ -0,0 +1,41 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-22 09:40:12
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-22 15:18:45
+ * @Description: 访存引用串记录。打开后Machine::Translate把每一次成功的地址转换记录为(ASID, vpn, 读/写, tick)，
+ *               以紧凑的二进制格式缓冲写入宿主机文件，供离线的页面替换模拟器(pagesim)回放。
+ *               文件格式：一个ReferenceTraceMagic字，之后每条记录两个字(宿主机字节序)：
+ *               第一个字低20位是vpn，第20位是写标志，高11位是ASID；第二个字是totalTicks
+ */
+#ifndef REFERENCETRACE_H
+#define REFERENCETRACE_H
+
+#define ReferenceTraceMagic 0x4e545243  //"NTRC"
+
+#define TraceVpnBits 20                 //和MaxVirtPages一致
+#define TraceVpnMask ((1 << TraceVpnBits) - 1)
+#define TraceWriteBit (1 << TraceVpnBits)
+#define TraceAsidShift (TraceVpnBits + 1)
+
+#define TraceBufferRecords 4096         //攒够这么多条记录才写一次文件
+
+class ReferenceTrace
+{
+    public:
+        ReferenceTrace(char* fileName);
+        ~ReferenceTrace();              //写出缓冲区中剩余的记录并关闭文件
+
+        void record(int asid, int vpn, bool writing, int tick);
+        int getRecordNums() {return recordNums;}
+
+    private:
+        int fileId;
+        unsigned int* buffer;           //每条记录占两个字
+        int bufferedNums;
+        int recordNums;
+
+        void flush();
+};
+
+#endif	// REFERENCETRACE_H
@@ -2,7 +2,7 @@
  * @Author: Lollipop
  * @Date: 2019-11-15 14:02:48
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 14:14:20
+ * @LastEditTime: 2019-11-16 17:44:51
  * @Description: 
  */
 #include "translate.h"
@@ -23,6 +23,8 @@ TLBManager::TLBManager()
         for (int j = 0; j < 4; j++)
         {
             tlbPtr[i][j].valid = false;
+            tlbPtr[i][j].dirty = false;
+            tlbPtr[i][j].pte = NULL;
             tlbPtr[i][j].threadId = -1;
         }
     }
@@ -36,11 +38,14 @@ TLBManager::~TLBManager()
     }
 }
 
-int TLBManager::translate(int virtAddr)
+//TLB项带有线程号，只有当前线程的TLB项才能命中；对只读页的写访问按缺失处理，由页表产生ReadOnlyException。
+//写命中只设置TLB项的脏位，不查页表
+int TLBManager::translate(int virtAddr, bool writing)
 {
     unsigned int TLBT, TLBI;
     unsigned int vpn, offset;
     int physAddr = -1;
+    int threadId = kernel->currentThread->getPid();
 
     vpn = (unsigned)virtAddr / PageSize;
     offset = (unsigned)virtAddr % PageSize;
@@ -50,9 +55,15 @@ int TLBManager::translate(int virtAddr)
 
     for (int i = 0; i < 4; i++)
     {
-        if (tlbPtr[TLBI][i].valid && (tlbPtr[TLBI][i].Tag == TLBT))
+        if (tlbPtr[TLBI][i].valid && (tlbPtr[TLBI][i].Tag == TLBT) && tlbPtr[TLBI][i].threadId == threadId)
         {
+            if (writing && tlbPtr[TLBI][i].readOnly)
+            {
+                break;
+            }
             tlbPtr[TLBI][i].lru = 0;
+            if (writing)
+                tlbPtr[TLBI][i].dirty = true;
             physAddr = tlbPtr[TLBI][i].PPN * PageSize + offset;
             break;
         }
@@ -60,7 +71,7 @@ int TLBManager::translate(int virtAddr)
     return physAddr;
 }
 
-void TLBManager::update(int virtAddr, int pageFrame)
+void TLBManager::update(int virtAddr, TranslationEntry *entry)
 {
     unsigned int vpn;
     unsigned int TLBT, TLBI;
@@ -69,36 +80,53 @@ void TLBManager::update(int virtAddr, int pageFrame)
     TLBI = vpn & 0x3;
     TLBT = (vpn >> 2) & 0x3FFFFFFF;
 
-    //替换的下标
-    int index = 0;
+    //替换的下标。同一页已有的旧TLB项(例如只读权限变化)直接覆盖
+    int threadId = kernel->currentThread->getPid();
+    int index = -1;
     for (int i = 0; i < 4; i++)
     {
-        if (tlbPtr[TLBI][i].valid)
-        {
-            tlbPtr[TLBI][i].lru++;
-            if (tlbPtr[TLBI][i].lru > tlbPtr[TLBI][index].lru)
-                index = i;
-        }
-        else
+        if (tlbPtr[TLBI][i].valid && tlbPtr[TLBI][i].Tag == TLBT && tlbPtr[TLBI][i].threadId == threadId)
         {
             index = i;
             break;
         }
     }
+    if (index == -1)
+    {
+        index = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            if (tlbPtr[TLBI][i].valid)
+            {
+                tlbPtr[TLBI][i].lru++;
+                if (tlbPtr[TLBI][i].lru > tlbPtr[TLBI][index].lru)
+                    index = i;
+            }
+            else
+            {
+                index = i;
+                break;
+            }
+        }
+    }
     if (tlbPtr[TLBI][index].valid)
     {
         DEBUG(dbgLru, "replace tlb ");
+        writeBack(&tlbPtr[TLBI][index]);
     }
     else
     {
         DEBUG(dbgLru, "update tlb ");
     }
     
-    tlbPtr[TLBI][index].PPN = pageFrame;
+    tlbPtr[TLBI][index].PPN = entry->getPhysicalPage();
     tlbPtr[TLBI][index].Tag = TLBT;
     tlbPtr[TLBI][index].valid = true;
+    tlbPtr[TLBI][index].readOnly = entry->isReadOnly();
+    tlbPtr[TLBI][index].dirty = false;
+    tlbPtr[TLBI][index].pte = entry;
     tlbPtr[TLBI][index].lru = 0;
-    tlbPtr[TLBI][index].threadId = kernel->currentThread->getPid();
+    tlbPtr[TLBI][index].threadId = threadId;
 }
 
 void TLBManager::invalidEntry(int threadId, int vpn)
@@ -111,7 +139,19 @@ void TLBManager::invalidEntry(int threadId, int vpn)
     {
         if (tlbPtr[TLBI][i].valid && tlbPtr[TLBI][i].Tag == TLBT && tlbPtr[TLBI][i].threadId == threadId)
         {
+            writeBack(&tlbPtr[TLBI][i]);
             tlbPtr[TLBI][i].valid = FALSE;
         }
     }
-}
\ No newline at end of file
+}
+
+//TLB项离开TLB之前把命中时积累的脏位写回页表项。
+//所有使页表项失效或者删除页表项的地方都先调用invalidEntry，所以有效的TLB项的页表项一定还在
+void TLBManager::writeBack(TLBEntry *tlbEntry)
+{
+    if (tlbEntry->dirty)
+    {
+        tlbEntry->pte->setDirty(TRUE);
+        tlbEntry->dirty = false;
+    }
+}
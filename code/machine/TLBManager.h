@@ -2,18 +2,23 @@
  * @Author: Lollipop
  * @Date: 2019-11-15 13:56:04
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 14:08:48
+ * @LastEditTime: 2019-11-16 17:44:51
  * @Description: 
  */
 #ifndef TLBMANAGER_H
 #define TLBMANAGER_H
 
+class TranslationEntry;
+
 class TLBEntry
 {
 public:
     unsigned int Tag;
     int PPN;
     bool valid;
+    bool readOnly;
+    bool dirty;                 //命中时的写访问只设置这一位，TLB项被替换或失效时再写回页表项
+    TranslationEntry *pte;      //装入这一项的页表项
     int threadId;
 
     unsigned int lru;
@@ -31,8 +36,11 @@ public:
 
     TLBManager();
     ~TLBManager();
-    int translate(int virtAddr);
-    void update(int virtAddr, int pageFrame);
+    int translate(int virtAddr, bool writing);
+    void update(int virtAddr, TranslationEntry *entry);
     void invalidEntry(int threadId, int vpn);
+
+private:
+    void writeBack(TLBEntry *tlbEntry);
 };
 #endif // TLBMANAGEH
\ No newline at end of file
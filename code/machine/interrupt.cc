@@ -235,6 +235,8 @@ Interrupt::Halt()
 {
     cout << "Machine halting!\n\n";
     kernel->stats->Print();
+    kernel->scheduler->PrintStatistics();
+    kernel->memoryManager->Print();
     delete kernel;	// Never returns.
 }
 
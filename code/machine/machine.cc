@@ -67,6 +67,12 @@ Machine::Machine(bool debug)
     tlbManager = NULL;
     pageTable = NULL;
 #endif
+#ifdef INVERTED_PAGETABLE
+    invertedPageTable = new InvertedPageTable(NumPhysPages);
+#endif
+    referenceTrace = NULL;
+    linkAddr = 0;
+    linkValid = FALSE;
     singleStep = debug;
     CheckEndian();
 }
@@ -82,6 +88,10 @@ Machine::~Machine()
 #ifdef USE_TLB
         delete tlbManager;
 #endif
+#ifdef INVERTED_PAGETABLE
+        delete invertedPageTable;
+#endif
+    delete referenceTrace;
 }
 
 //----------------------------------------------------------------------
@@ -25,6 +25,9 @@
 #include "utility.h"
 #include "translate.h"
 #include "TLBManager.h"
+#include "PageTable.h"
+#include "InvertedPageTable.h"
+#include "ReferenceTrace.h"
 
 enum ExceptionType
 {
@@ -107,7 +110,7 @@ public:
 	// NOTE: the hardware translation of virtual addresses in the user program
 	// to physical addresses (relative to the beginning of "mainMemory")
 	// can be controlled by one of:
-	//	a traditional linear page table
+	//	a multi-level page table (see PageTable.h)
 	//  	a software-loaded translation lookaside buffer (tlb) -- a cache of
 	//	  mappings of virtual page #'s to physical page #'s
 	//
@@ -125,14 +128,28 @@ public:
 	TLBManager *tlbManager; // this pointer should be considered
 			  // "read-only" to Nachos kernel code
 
-	TranslationEntry *pageTable;
-	unsigned int pageTableSize;
+	PageTable *pageTable;	// page table of the current address space
+
+#ifdef INVERTED_PAGETABLE
+	InvertedPageTable *invertedPageTable;	// resident pages of every
+				// address space, keyed by (ASID, vpn); the
+				// only translation structure in this mode
+#endif
+
+	ReferenceTrace *referenceTrace;	// if non-NULL, every successful
+				// translation is logged here (nachos -rt)
 
 	bool ReadMem(int addr, int size, int *value);
 	bool WriteMem(int addr, int size, int value);
 	// Read or write 1, 2, or 4 bytes of virtual
 	// memory (at addr).  Return FALSE if a
 	// correct translation couldn't be found.
+
+	void BreakLink() { linkValid = FALSE; }
+	// Make the next SC (store conditional) fail.
+	// Called on every context switch, so that an
+	// LL/SC pair only succeeds if no other thread
+	// ran in between.
 private:
 	// Routines internal to the machine simulation -- DO NOT call these directly
 	void DelayedLoad(int nextReg, int nextVal);
@@ -159,12 +176,16 @@ private:
 
 	int registers[NumTotalRegs]; // CPU registers, for executing user programs
 
+	int linkAddr;	// address of the last LL
+	bool linkValid;	// FALSE once an SC to linkAddr must fail
+
 	bool singleStep; // drop back into the debugger after each
 		// simulated instruction
 	int runUntilTime; // drop back into the debugger when simulated
 		// time reaches this value
 
 	friend class Interrupt; // calls DelayedLoad()
+	friend class Kernel;    // TranslateBenchmark() calls Translate()
 };
 
 extern void ExceptionHandler(ExceptionType which);
@@ -321,6 +321,21 @@ void Machine::OneInstruction(Instruction *instr)
 		nextLoadValue = value;
 		break;
 
+	case OP_LL:
+		tmp = registers[instr->rs] + instr->extra;
+		if (tmp & 0x3)
+		{
+			RaiseException(AddressErrorException, tmp);
+			return;
+		}
+		if (!ReadMem(tmp, 4, &value))
+			return;
+		nextLoadReg = instr->rt;
+		nextLoadValue = value;
+		linkAddr = tmp;
+		linkValid = TRUE;
+		break;
+
 	case OP_LWL:
 		tmp = registers[instr->rs] + instr->extra;
 
@@ -557,6 +572,34 @@ void Machine::OneInstruction(Instruction *instr)
 			return;
 		break;
 
+	case OP_SC:
+		// Store only if nothing has run on the CPU since the LL.
+		// Translate first: serving a fault may switch threads,
+		// which breaks the link, and the restarted SC then fails.
+		tmp = registers[instr->rs] + instr->extra;
+		if (tmp & 0x3)
+		{
+			RaiseException(AddressErrorException, tmp);
+			return;
+		}
+		if (linkValid && linkAddr == tmp)
+		{
+			ExceptionType exception = Translate(tmp, &value, 4, TRUE);
+			if (exception != NoException)
+			{
+				RaiseException(exception, tmp);
+				return;
+			}
+			*(unsigned int *)&mainMemory[value] = WordToMachine(registers[instr->rt]);
+			registers[instr->rt] = 1;
+		}
+		else
+		{
+			registers[instr->rt] = 0;
+		}
+		linkValid = FALSE;
+		break;
+
 	case OP_SWL:
 		tmp = registers[instr->rs] + instr->extra;
 
@@ -22,6 +22,8 @@ Statistics::Statistics()
     numDiskReads = numDiskWrites = 0;
     numConsoleCharsRead = numConsoleCharsWritten = 0;
     numPageFaults = numPacketsSent = numPacketsRecvd = 0;
+    numContextSwitches = numPreemptions = 0;
+    numRealTimeJobs = numDeadlineMisses = numBudgetOverruns = 0;
 }
 
 //----------------------------------------------------------------------
@@ -42,4 +44,16 @@ Statistics::Print()
     cout << "Paging: faults " << numPageFaults << "\n";
     cout << "Network I/O: packets received " << numPacketsRecvd;
 		cout << ", sent " << numPacketsSent << "\n";
+    cout << "Scheduling: context switches " << numContextSwitches;
+    cout << ", preemptions " << numPreemptions;
+    if (totalTicks > 0) {		// a tick is roughly a microsecond
+	cout << ", " << (int)(numContextSwitches * 1000000.0 / totalTicks)
+	     << " switches per second";
+    }
+    cout << "\n";
+    if (numRealTimeJobs > 0) {
+	cout << "Real-time: jobs " << numRealTimeJobs;
+	cout << ", deadline misses " << numDeadlineMisses;
+	cout << ", budget overruns " << numBudgetOverruns << "\n";
+    }
 }
@@ -35,6 +35,14 @@ class Statistics {
     int numPageFaults;		// number of virtual memory page faults
     int numPacketsSent;		// number of packets sent over the network
     int numPacketsRecvd;	// number of packets received over the network
+    int numContextSwitches;	// number of times the CPU changed threads
+    int numPreemptions;		// number of times a thread was forced off
+				// the CPU, by its quantum running out or
+				// by an earlier real-time deadline
+    int numRealTimeJobs;	// number of real-time jobs completed
+    int numDeadlineMisses;	// of those, how many finished late
+    int numBudgetOverruns;	// number of times a real-time thread used
+				// up its budget for a period
 
     Statistics(); 		// initialize everything to zero
 
@@ -92,17 +92,17 @@ bool Machine::ReadMem(int addr, int size, int *value)
 	DEBUG(dbgAddr, "Reading VA " << addr << ", size " << size);
 
 	exception = Translate(addr, &physicalAddress, size, FALSE);
+	while (exception == PageFaultException)
+	{
+		//缺页处理之后重新翻译，页可能在处理期间又被换出，要一直重试到它在内存中；
+		//非法地址在缺页处理中就会终止，不会一直循环。写时复制的页这时还可能产生ReadOnlyException
+		RaiseException(exception, addr);
+		exception = Translate(addr, &physicalAddress, size, FALSE);
+	}
 	if (exception != NoException)
 	{
 		RaiseException(exception, addr);
-		if (exception == PageFaultException)
-		{
-			exception = Translate(addr, &physicalAddress, size, FALSE);
-		}
-		else
-		{
-			return FALSE;
-		}
+		return FALSE;
 	}
 	switch (size)
 	{
@@ -150,17 +150,17 @@ bool Machine::WriteMem(int addr, int size, int value)
 	DEBUG(dbgAddr, "Writing VA " << addr << ", size " << size << ", value " << value);
 
 	exception = Translate(addr, &physicalAddress, size, TRUE);
+	while (exception == PageFaultException)
+	{
+		//缺页处理之后重新翻译，页可能在处理期间又被换出，要一直重试到它在内存中；
+		//非法地址在缺页处理中就会终止，不会一直循环。写时复制的页这时还可能产生ReadOnlyException
+		RaiseException(exception, addr);
+		exception = Translate(addr, &physicalAddress, size, TRUE);
+	}
 	if (exception != NoException)
 	{
 		RaiseException(exception, addr);
-		if (exception == PageFaultException)
-		{
-			exception = Translate(addr, &physicalAddress, size, TRUE);
-		}
-		else
-		{
-			return FALSE;
-		}
+		return FALSE;
 		
 	}
 	switch (size)
@@ -227,35 +227,38 @@ Machine::Translate(int virtAddr, int *physAddr, int size, bool writing)
 #ifdef USE_TLB
 	//首先在TLB中查找，如果成功则返回，否则在页表中查找，并更新TLB。
 
-	int res = tlbManager->translate(virtAddr);
+	int res = tlbManager->translate(virtAddr, writing);
 	if (res >= 0)
 	{
 		DEBUG(dbgLru, "use TLB ");
+		//写命中的脏位记在TLB项中，TLB项被替换或失效时才写回页表项(见TLBManager::writeBack)
+		if (referenceTrace != NULL)
+			referenceTrace->record(kernel->currentThread->getPid(), vpn, writing, kernel->stats->totalTicks);
 		*physAddr = res;
 		return NoException;
 	}
 #endif
 
 	//tlb miss,查页表
-	if (vpn >= pageTableSize)
+	if (vpn >= (unsigned)pageTable->getNumPages())
 	{
 		DEBUG(dbgAddr, "Illegal virtual page # " << virtAddr);
 		return AddressErrorException;
 	}
-	//pageFault
-	else if (!pageTable[vpn].valid)
+	//pageFault: 页没有被访问过时叶子表可能还没有分配
+	entry = pageTable->lookup(vpn);
+	if (entry == NULL || !entry->isValid())
 	{
 		DEBUG(dbgAddr, "pageFaultException # " << virtAddr);
 		return PageFaultException;
 	}
-	entry = &pageTable[vpn];
-	
-	if (entry->readOnly && writing)
+
+	if (entry->isReadOnly() && writing)
 	{ // trying to write to a read-only page
 		DEBUG(dbgAddr, "Write to read-only page at " << virtAddr);
 		return ReadOnlyException;
 	}
-	pageFrame = entry->physicalPage;
+	pageFrame = entry->getPhysicalPage();
 
 	// if the pageFrame is too big, there is something really wrong!
 	// An invalid translation was loaded into the page table or TLB.
@@ -267,12 +270,15 @@ Machine::Translate(int virtAddr, int *physAddr, int size, bool writing)
 
 #ifdef USE_TLB
 	//更新TLB
-	tlbManager->update(virtAddr, pageFrame);
+	tlbManager->update(virtAddr, entry);
 #endif
 
-	//entry->use = TRUE; // set the use, dirty bits
+	//entry->setUsed(TRUE); // set the use, dirty bits
 	if (writing)
-		entry->dirty = TRUE;
+		entry->setDirty(TRUE);
+	//只记录成功的转换，缺页后重新执行的访问不会被记录两次
+	if (referenceTrace != NULL)
+		referenceTrace->record(kernel->currentThread->getPid(), vpn, writing, kernel->stats->totalTicks);
 	*physAddr = pageFrame * PageSize + offset;
 	ASSERT((*physAddr >= 0) && ((*physAddr + size) <= PhysicalMemorySize));
 	DEBUG(dbgAddr, "phys addr = " << *physAddr);
@@ -28,25 +28,58 @@
 #include "copyright.h"
 #include "utility.h"
 #include "memory.h"
-// The following class defines an entry in a translation table -- either
-// in a page table or a TLB.  Each entry defines a mapping from one
-// virtual page to one physical page.
+// The following class defines an entry in a page table.  Each entry
+// defines a mapping from one virtual page to one physical page; the
+// virtual page number is implied by the entry's position in the table.
 // In addition, there are some extra bits for access control (valid and
 // read-only) and some bits for usage information (use and dirty).
+//
+// The whole entry is packed into one 32-bit word: the physical page
+// number in the upper bits and the four flags in the lowest four, so
+// that a page table leaf fits in as few cache lines as possible.
+// The TLB keeps its own entries (see TLBManager.h).
+
+#define PTEValidBit	0x1	// If this bit is clear, the translation is ignored.
+				// (In other words, the entry hasn't been initialized.)
+#define PTEReadOnlyBit	0x2	// The user program is not allowed to modify
+				// the contents of the page.
+#define PTEUseBit	0x4	// Set every time the page is referenced or modified.
+#define PTEDirtyBit	0x8	// Set every time the page is modified.
+#define PTEFrameShift	4	// The physical page number (relative to the
+				// start of "mainMemory") lives above the flags
 
 class TranslationEntry
 {
 public:
-  int virtualPage;  // The page number in virtual memory.
-  int physicalPage; // The page number in real memory (relative to the
-                    //  start of "mainMemory"
-  bool valid;       // If this bit is set, the translation is ignored.
-                    // (In other words, the entry hasn't been initialized.)
-  bool readOnly;    // If this bit is set, the user program is not allowed
-                    // to modify the contents of the page.
-  bool use;         // This bit is set by the hardware every time the
-                    // page is referenced or modified.
-  bool dirty;       // This bit is set by the hardware every time the
-                    // page is modified.
+  TranslationEntry() { bits = 0; }
+
+  int getPhysicalPage() { return bits >> PTEFrameShift; }
+  void setPhysicalPage(int page)
+  {
+    bits = (bits & ((1 << PTEFrameShift) - 1)) | ((unsigned int)page << PTEFrameShift);
+  }
+
+  bool isValid() { return (bits & PTEValidBit) != 0; }
+  bool isReadOnly() { return (bits & PTEReadOnlyBit) != 0; }
+  bool isUsed() { return (bits & PTEUseBit) != 0; }
+  bool isDirty() { return (bits & PTEDirtyBit) != 0; }
+
+  void setValid(bool on) { setBit(PTEValidBit, on); }
+  void setReadOnly(bool on) { setBit(PTEReadOnlyBit, on); }
+  void setUsed(bool on) { setBit(PTEUseBit, on); }
+  void setDirty(bool on) { setBit(PTEDirtyBit, on); }
+
+  void clear() { bits = 0; } // invalid, no frame, all flags off
+
+private:
+  unsigned int bits;
+
+  void setBit(unsigned int bit, bool on)
+  {
+    if (on)
+      bits |= bit;
+    else
+      bits &= ~bit;
+  }
 };
 #endif
@@ -0,0 +1,82 @@
+/* futex.c
+ *	Test the user-level mutexes and condition variables of usync.c.
+ *
+ *	The parent and NumChildren forked children each add 1 to a
+ *	counter in a shared-memory segment Rounds times, under a mutex.
+ *	The read-modify-write is slowed down so that time slicing
+ *	catches some processes inside it.  Each process signals the
+ *	parent when it is done.  The parent then passes two pairs to
+ *	Add: the counter and the count it should reach, and the futex
+ *	system calls the parent made and the lock operations it did.
+ *	They show up in the syscall debug output:
+ *
+ *		nachos -q 100 -d u -x ../test/futex.noff
+ *
+ *	Only a small fraction of the lock operations should have
+ *	trapped into the kernel.
+ */
+
+#include "syscall.h"
+#include "usync.h"
+
+#define NumChildren	2
+#define Rounds		1000
+
+typedef struct {
+  Mutex lock;
+  CondVar finished;
+  int counter;
+  int done;
+} Shared;
+
+static void
+Count(Shared *shared)
+{
+  volatile int delay;
+  int i, value;
+
+  for (i = 0; i < Rounds; i++) {
+    MutexLock(&shared->lock);
+    value = shared->counter;
+    for (delay = 0; delay < 10; delay++)
+      ;
+    shared->counter = value + 1;
+    MutexUnlock(&shared->lock);
+  }
+
+  MutexLock(&shared->lock);
+  shared->done++;
+  CondSignal(&shared->finished, &shared->lock);
+  MutexUnlock(&shared->lock);
+}
+
+int
+main()
+{
+  Shared *shared;
+  int i, park = 0;
+
+  shared = (Shared *) ShmCreate("futex", sizeof(Shared));
+  if ((int) shared == -1)
+    Halt();
+
+  for (i = 0; i < NumChildren; i++) {
+    if (Fork() == 0) {
+      shared = (Shared *) ShmAttach("futex");
+      Count(shared);
+      for (;;)			/* no Exit for forked processes */
+        FutexWait(&park, 0);
+    }
+  }
+  Count(shared);
+
+  MutexLock(&shared->lock);
+  while (shared->done < NumChildren + 1)
+    CondWait(&shared->finished, &shared->lock);
+  MutexUnlock(&shared->lock);
+
+  Add(shared->counter, (NumChildren + 1) * Rounds);
+  Add(usyncSyscalls, Rounds + 2);
+  Halt();
+  /* not reached */
+}
@@ -0,0 +1,50 @@
+/* heap.c
+ *	Simple program to test Sbrk and the user-level malloc.
+ *
+ *	Allocate arrays whose sizes are only known at run time, fill
+ *	them in, free every other one and allocate again so that freed
+ *	blocks get reused.  The checksum is passed to Add so it shows up
+ *	in the syscall debug output (nachos -d u -x ../test/heap.noff).
+ */
+
+#include "syscall.h"
+#include "malloc.h"
+
+#define NumArrays	8
+
+int
+main()
+{
+  int *arrays[NumArrays];
+  int i, j, n, sum = 0;
+
+  for (i = 0; i < NumArrays; i++) {
+    n = 16 << (i % 4);
+    arrays[i] = (int *) malloc(n * sizeof(int));
+    if (arrays[i] == 0)
+      Halt();
+    for (j = 0; j < n; j++)
+      arrays[i][j] = j;
+  }
+
+  for (i = 0; i < NumArrays; i += 2)
+    free(arrays[i]);
+  for (i = 0; i < NumArrays; i += 2) {
+    arrays[i] = (int *) malloc(32 * sizeof(int));
+    if (arrays[i] == 0)
+      Halt();
+    for (j = 0; j < 32; j++)
+      arrays[i][j] = 1;
+  }
+
+  for (i = 0; i < NumArrays; i++) {
+    n = (i % 2 == 0) ? 32 : 16 << (i % 4);
+    for (j = 0; j < n; j++)
+      sum += arrays[i][j];
+    free(arrays[i]);
+  }
+
+  Add(sum, 0);
+  Halt();
+  /* not reached */
+}
@@ -0,0 +1,106 @@
+/* malloc.c
+ *	A small first-fit allocator for user programs, after the one in
+ *	Kernighan and Ritchie, section 8.7.
+ *
+ *	Free blocks sit on a circular list sorted by address; a freed
+ *	block is merged with the free blocks on either side of it.  When
+ *	no free block is big enough, the heap is grown with Sbrk, at
+ *	least MinGrowUnits headers at a time so that we do not trap into
+ *	the kernel for every small request.
+ */
+
+#include "syscall.h"
+#include "malloc.h"
+
+typedef struct header {
+  struct header *next;		/* next block on the free list */
+  unsigned int size;		/* size of this block, in headers,
+				   counting the header itself */
+} Header;
+
+#define MinGrowUnits	128
+
+static Header base;		/* empty list to get started */
+static Header *freep = 0;	/* where the last search stopped */
+
+/* Ask the kernel for room for at least "units" headers and put it on
+ * the free list.
+ */
+static Header *
+morecore(unsigned int units)
+{
+  Header *up;
+  int cp;
+
+  if (units < MinGrowUnits)
+    units = MinGrowUnits;
+  cp = Sbrk(units * sizeof(Header));
+  if (cp == -1)
+    return 0;
+
+  up = (Header *) cp;
+  up->size = units;
+  free((void *) (up + 1));
+  return freep;
+}
+
+void *
+malloc(unsigned int nbytes)
+{
+  Header *p, *prevp;
+  unsigned int units;
+
+  if (nbytes == 0)
+    return 0;
+  units = (nbytes + sizeof(Header) - 1) / sizeof(Header) + 1;
+
+  if ((prevp = freep) == 0) {
+    base.next = freep = prevp = &base;
+    base.size = 0;
+  }
+
+  for (p = prevp->next; ; prevp = p, p = p->next) {
+    if (p->size >= units) {
+      if (p->size == units)
+        prevp->next = p->next;
+      else {			/* hand out the tail end */
+        p->size -= units;
+        p += p->size;
+        p->size = units;
+      }
+      freep = prevp;
+      return (void *) (p + 1);
+    }
+    if (p == freep)		/* wrapped around the free list */
+      if ((p = morecore(units)) == 0)
+        return 0;
+  }
+}
+
+void
+free(void *ptr)
+{
+  Header *bp, *p;
+
+  if (ptr == 0)
+    return;
+  bp = (Header *) ptr - 1;
+
+  for (p = freep; !(bp > p && bp < p->next); p = p->next)
+    if (p >= p->next && (bp > p || bp < p->next))
+      break;			/* freed block at either end of the heap */
+
+  if (bp + bp->size == p->next) {	/* join to upper neighbour */
+    bp->size += p->next->size;
+    bp->next = p->next->next;
+  } else
+    bp->next = p->next;
+
+  if (p + p->size == bp) {		/* join to lower neighbour */
+    p->size += bp->size;
+    p->next = bp->next;
+  } else
+    p->next = bp;
+
+  freep = p;
+}
@@ -0,0 +1,17 @@
+/* malloc.h
+ *	Dynamic memory for user programs, built on the Sbrk system call.
+ *	Link with malloc.o (see LIB_SOURCES in the Makefile).
+ */
+
+#ifndef MALLOC_H
+#define MALLOC_H
+
+/* Return a block of at least "nbytes" bytes, or 0 if the heap cannot
+ * grow any further.
+ */
+void *malloc(unsigned int nbytes);
+
+/* Give back a block returned by malloc; freeing 0 does nothing. */
+void free(void *ptr);
+
+#endif /* MALLOC_H */
@@ -0,0 +1,34 @@
+/* memstat.c
+ *	Simple program to test the MemStat system call.
+ *
+ *	Touch a large array one page at a time and report how many zero
+ *	fills, minor and major faults it took, as seen by the system-wide
+ *	counters.  The numbers are passed to Add so they show up in the
+ *	syscall debug output (nachos -d u -x ../test/memstat.noff); the
+ *	per-process breakdown is printed when the machine halts.
+ */
+
+#include "syscall.h"
+
+#define ArrayPages	24
+#define PageInts	(128 / sizeof(int))
+
+int array[ArrayPages * PageInts];
+
+int
+main()
+{
+  int zeroFills = MemStat(-1, MEMSTAT_ZERO_FILLS);
+  int minor = MemStat(-1, MEMSTAT_MINOR_FAULTS);
+  int major = MemStat(-1, MEMSTAT_MAJOR_FAULTS);
+  int i;
+
+  for (i = 0; i < ArrayPages; i++)
+    array[i * PageInts] = i;
+
+  Add(MemStat(-1, MEMSTAT_ZERO_FILLS) - zeroFills, 0);
+  Add(MemStat(-1, MEMSTAT_MINOR_FAULTS) - minor, MemStat(-1, MEMSTAT_MAJOR_FAULTS) - major);
+  Add(MemStat(-1, MEMSTAT_RESIDENT), MemStat(-1, MEMSTAT_EVICTIONS));
+  Halt();
+  /* not reached */
+}
@@ -0,0 +1,30 @@
+/* mmap.c
+ *	Simple program to test the Mmap/Munmap system calls.
+ *
+ *	Map this program's own executable and checksum it through
+ *	memory; only the pages that are touched get read from the file.
+ *	The sum is passed to Add so it shows up in the syscall debug output
+ *	(nachos -d u -x ../test/mmap.noff).
+ */
+
+#include "syscall.h"
+
+int
+main()
+{
+  char *data;
+  int i, sum = 0;
+
+  data = (char *) Mmap("../test/mmap.noff", 0, 512);
+  if ((int) data == -1)
+    Halt();
+
+  for (i = 0; i < 512; i++)
+    sum += data[i];
+
+  Add(sum, 0);
+  Munmap((int) data);
+
+  Halt();
+  /* not reached */
+}
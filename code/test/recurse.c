@@ -0,0 +1,30 @@
+/* recurse.c
+ *	Simple program to test stack growth.
+ *
+ *	Recurse deep enough to need many more stack pages than the one
+ *	the stack starts with; each fault below the stack grows it.  The
+ *	depth reached is passed to Add so it shows up in the syscall
+ *	debug output (nachos -d u -x ../test/recurse.noff).
+ */
+
+#include "syscall.h"
+
+int
+depth(int n)
+{
+  int pad[8];
+
+  pad[n % 8] = n;
+  if (n == 0)
+    return 0;
+  return pad[n % 8] - n + 1 + depth(n - 1);
+}
+
+int
+main()
+{
+  Add(depth(100), 0);
+
+  Halt();
+  /* not reached */
+}
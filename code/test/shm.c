@@ -0,0 +1,33 @@
+/* shm.c
+ *	Simple program to test the shared-memory system calls.
+ *
+ *	Create a segment, attach it a second time at another address and
+ *	check that a write through one mapping is visible through the
+ *	other.  The value read back is passed to Add so it shows up in
+ *	the syscall debug output (nachos -d u -x ../test/shm.noff).
+ */
+
+#include "syscall.h"
+
+int
+main()
+{
+  int *first, *second;
+
+  first = (int *) ShmCreate("counter", 2048);
+  if ((int) first == -1)
+    Halt();
+  second = (int *) ShmAttach("counter");
+  if ((int) second == -1)
+    Halt();
+
+  first[0] = 17;
+  first[300] = 25;
+  Add(second[0], second[300]);
+
+  ShmDetach((int) first);
+  ShmDetach((int) second);
+
+  Halt();
+  /* not reached */
+}
@@ -90,6 +90,94 @@ Join:
 	j	$31
 	.end Join
 
+	.globl Fork
+	.ent	Fork
+Fork:
+	addiu $2,$0,SC_Fork
+	syscall
+	j	$31
+	.end Fork
+
+	.globl Mmap
+	.ent	Mmap
+Mmap:
+	addiu $2,$0,SC_Mmap
+	syscall
+	j	$31
+	.end Mmap
+
+	.globl Munmap
+	.ent	Munmap
+Munmap:
+	addiu $2,$0,SC_Munmap
+	syscall
+	j	$31
+	.end Munmap
+
+	.globl ShmCreate
+	.ent	ShmCreate
+ShmCreate:
+	addiu $2,$0,SC_ShmCreate
+	syscall
+	j	$31
+	.end ShmCreate
+
+	.globl ShmAttach
+	.ent	ShmAttach
+ShmAttach:
+	addiu $2,$0,SC_ShmAttach
+	syscall
+	j	$31
+	.end ShmAttach
+
+	.globl ShmDetach
+	.ent	ShmDetach
+ShmDetach:
+	addiu $2,$0,SC_ShmDetach
+	syscall
+	j	$31
+	.end ShmDetach
+
+	.globl Sbrk
+	.ent	Sbrk
+Sbrk:
+	addiu $2,$0,SC_Sbrk
+	syscall
+	j	$31
+	.end Sbrk
+
+	.globl MemStat
+	.ent	MemStat
+MemStat:
+	addiu $2,$0,SC_MemStat
+	syscall
+	j	$31
+	.end MemStat
+
+	.globl SetTickets
+	.ent	SetTickets
+SetTickets:
+	addiu $2,$0,SC_SetTickets
+	syscall
+	j	$31
+	.end SetTickets
+
+	.globl FutexWait
+	.ent	FutexWait
+FutexWait:
+	addiu $2,$0,SC_FutexWait
+	syscall
+	j	$31
+	.end FutexWait
+
+	.globl FutexWake
+	.ent	FutexWake
+FutexWake:
+	addiu $2,$0,SC_FutexWake
+	syscall
+	j	$31
+	.end FutexWake
+
 	.globl Create
 	.ent	Create
 Create:
@@ -218,6 +306,51 @@ Clock:
 	j       $31
 	.end Clock
 
+/* -------------------------------------------------------------
+ * CompareAndSwap, AtomicSwap
+ *	Atomic operations for the user-level locks in usync.c, built
+ *	from LL and SC: the SC only stores if no other thread ran since
+ *	the LL, otherwise we try again.
+ *
+ *	CompareAndSwap(addr, old, new) stores "new" at "addr" if it
+ *	holds "old"; AtomicSwap(addr, new) stores "new" unconditionally.
+ *	Both return the word that was at "addr".
+ *
+ *	Delay slots are filled by hand, since the simulator delays
+ *	loads by one instruction.
+ * -------------------------------------------------------------
+ */
+
+	.globl CompareAndSwap
+	.ent	CompareAndSwap
+CompareAndSwap:
+	.set	noreorder
+1:	ll	$2,0($4)
+	nop
+	bne	$2,$5,2f
+	move	$8,$6
+	sc	$8,0($4)
+	beq	$8,$0,1b
+	nop
+2:	j	$31
+	nop
+	.set	reorder
+	.end CompareAndSwap
+
+	.globl AtomicSwap
+	.ent	AtomicSwap
+AtomicSwap:
+	.set	noreorder
+1:	ll	$2,0($4)
+	move	$8,$5
+	sc	$8,0($4)
+	beq	$8,$0,1b
+	nop
+	j	$31
+	nop
+	.set	reorder
+	.end AtomicSwap
+
 /* dummy function to keep gcc happy */
         .globl  __main
         .ent    __main
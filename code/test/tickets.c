@@ -0,0 +1,41 @@
+/* tickets.c
+ *	Simple program to test the SetTickets system call.
+ *
+ *	Fork a child, give the parent three times the tickets of the
+ *	child, and let both count as fast as they can in a shared-memory
+ *	segment.  When the parent has counted to Rounds it passes both
+ *	counts to Add, so they show up in the syscall debug output
+ *	(nachos -sp stride -d u -x ../test/tickets.noff); the child's
+ *	count should be about a third of the parent's.
+ */
+
+#include "syscall.h"
+
+#define Rounds		20000
+
+int
+main()
+{
+  volatile int *counts;
+  int child;
+
+  counts = (volatile int *) ShmCreate("tickets", 2 * sizeof(int));
+  if ((int) counts == -1)
+    Halt();
+  counts[0] = counts[1] = 0;
+
+  child = Fork();
+  if (child == 0) {
+    counts = (volatile int *) ShmAttach("tickets");
+    SetTickets(-1, 100);
+    for (;;)
+      counts[1]++;
+  }
+
+  SetTickets(-1, 300);
+  while (counts[0] < Rounds)
+    counts[0]++;
+  Add(counts[0], counts[1]);
+  Halt();
+  /* not reached */
+}
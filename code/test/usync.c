@@ -0,0 +1,97 @@
+/* usync.c
+ *	User-level mutexes and condition variables (see usync.h).
+ *
+ *	The mutex is the third one in Drepper's "Futexes Are Tricky".
+ *	Lock takes a free mutex with one compare-and-swap.  Otherwise
+ *	it marks the mutex 2, "maybe waited for", and sleeps in the
+ *	kernel until it gets the mutex.  Unlock has to call FutexWake
+ *	only if the mutex was marked 2.
+ *
+ *	A condition is a sequence number.  A waiter notes the number
+ *	before it lets go of the mutex.  FutexWait then puts it to
+ *	sleep only if no signal has bumped the number since, so a
+ *	signal cannot slip in unnoticed.  A woken waiter retakes the
+ *	mutex marked 2: other threads may still be asleep on it.
+ */
+
+#include "syscall.h"
+#include "usync.h"
+
+int usyncSyscalls = 0;
+
+void
+MutexInit(Mutex *mutex)
+{
+  mutex->state = 0;
+}
+
+void
+MutexLock(Mutex *mutex)
+{
+  int c;
+
+  if ((c = CompareAndSwap(&mutex->state, 0, 1)) == 0)
+    return;			/* the fast path */
+
+  if (c != 2)
+    c = AtomicSwap(&mutex->state, 2);
+  while (c != 0) {
+    usyncSyscalls++;
+    FutexWait((int *) &mutex->state, 2);
+    c = AtomicSwap(&mutex->state, 2);
+  }
+}
+
+void
+MutexUnlock(Mutex *mutex)
+{
+  if (AtomicSwap(&mutex->state, 0) == 2) {
+    usyncSyscalls++;
+    FutexWake((int *) &mutex->state, 1);
+  }
+}
+
+void
+CondInit(CondVar *cond)
+{
+  cond->seq = 0;
+  cond->waiters = 0;
+}
+
+void
+CondWait(CondVar *cond, Mutex *mutex)
+{
+  int seq = cond->seq;
+
+  cond->waiters++;
+  MutexUnlock(mutex);
+
+  usyncSyscalls++;
+  FutexWait((int *) &cond->seq, seq);
+
+  while (AtomicSwap(&mutex->state, 2) != 0) {
+    usyncSyscalls++;
+    FutexWait((int *) &mutex->state, 2);
+  }
+  cond->waiters--;
+}
+
+void
+CondSignal(CondVar *cond, Mutex *mutex)
+{
+  if (cond->waiters > 0) {
+    cond->seq++;
+    usyncSyscalls++;
+    FutexWake((int *) &cond->seq, 1);
+  }
+}
+
+void
+CondBroadcast(CondVar *cond, Mutex *mutex)
+{
+  if (cond->waiters > 0) {
+    cond->seq++;
+    usyncSyscalls++;
+    FutexWake((int *) &cond->seq, cond->waiters);
+  }
+}
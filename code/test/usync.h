@@ -0,0 +1,48 @@
+/* usync.h
+ *	Mutexes and condition variables for user programs, built on the
+ *	FutexWait and FutexWake system calls.  Link with usync.o (see
+ *	LIB_SOURCES in the Makefile).
+ *
+ *	Locking a free mutex, and unlocking one nobody waits for, takes
+ *	a handful of instructions and no system call; only a thread that
+ *	has to wait, or has to wake up a waiter, traps into the kernel.
+ *	To synchronize processes, put the mutexes and conditions in a
+ *	shared-memory segment (ShmCreate).  All zeroes is the initial
+ *	state of both, so a fresh segment needs no initialization.
+ */
+
+#ifndef USYNC_H
+#define USYNC_H
+
+typedef struct {
+  volatile int state;		/* 0 free, 1 locked, 2 locked and
+				   maybe waited for */
+} Mutex;
+
+typedef struct {
+  volatile int seq;		/* bumped by every signal; the futex */
+  volatile int waiters;		/* threads in CondWait */
+} CondVar;
+
+void MutexInit(Mutex *mutex);
+void MutexLock(Mutex *mutex);
+void MutexUnlock(Mutex *mutex);
+
+/* As in the kernel (threads/synch.h), conditions have Mesa semantics,
+ * and the caller must hold "mutex" for all three operations.
+ */
+void CondInit(CondVar *cond);
+void CondWait(CondVar *cond, Mutex *mutex);
+void CondSignal(CondVar *cond, Mutex *mutex);
+void CondBroadcast(CondVar *cond, Mutex *mutex);
+
+/* Number of futex system calls this process has made: a measure of
+ * how often it found its locks contended.
+ */
+extern int usyncSyscalls;
+
+/* Atomic operations, in start.s.  Both return the old value at "addr". */
+int CompareAndSwap(volatile int *addr, int old, int new);
+int AtomicSwap(volatile int *addr, int new);
+
+#endif /* USYNC_H */
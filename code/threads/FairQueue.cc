@@ -0,0 +1,107 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-24 13:22:10
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 10:31:15
+ * @Description:
+ */
+#include "FairQueue.h"
+#include "main.h"
+
+//nice值-20到19的权重，和Linux的sched_prio_to_weight相同
+static const int niceToWeight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15,
+};
+
+FairQueue::FairQueue()
+{
+    totalWeight = 0;
+    minVruntime = 0;
+}
+
+/**
+ * @description: 线程进入就绪队列。阻塞了很久的线程最多得到半个CfsTargetLatency的补偿，
+ *               否则它醒来后会长时间独占CPU
+ * @param {Thread* thread}
+ * @return:
+ */
+void
+FairQueue::Append(Thread* thread)
+{
+    thread->vruntime = max(thread->vruntime, minVruntime - CfsTargetLatency / 2);
+    heap.Insert(thread);
+    thread->readyWeight = getWeight(thread);
+    totalWeight += thread->readyWeight;
+}
+
+/**
+ * @description: 取出vruntime最小的线程
+ * @param none
+ * @return: 队列为空时返回NULL
+ */
+Thread*
+FairQueue::RemoveFront()
+{
+    Thread* thread = heap.RemoveMin();
+
+    if (thread == NULL)
+    {
+        return NULL;
+    }
+
+    totalWeight -= thread->readyWeight;
+    minVruntime = max(minVruntime, thread->vruntime);
+    return thread;
+}
+
+void
+FairQueue::Apply(void (*func)(Thread*))
+{
+    heap.Apply(func);
+}
+
+/**
+ * @description: 就绪线程被捐赠或收回了优先级，权重随之改变。堆按vruntime排序，位置不用变，
+ *               只要把totalWeight中它的旧权重换成新权重
+ * @param {Thread* thread}
+ * @return:
+ */
+void
+FairQueue::Reprioritize(Thread* thread)
+{
+    totalWeight -= thread->readyWeight;
+    thread->readyWeight = getWeight(thread);
+    totalWeight += thread->readyWeight;
+}
+
+void
+FairQueue::Charge(Thread* thread, int ticks)
+{
+    thread->vruntime += (long long)ticks * CfsNiceZeroWeight / getWeight(thread);
+}
+
+/**
+ * @description: 线程的时间片：CfsTargetLatency按权重分给它和所有就绪线程
+ * @param {Thread* thread} 正在运行的线程，不在就绪队列中
+ * @return:
+ */
+int
+FairQueue::getQuantum(Thread* thread)
+{
+    int weight = getWeight(thread);
+
+    return max(CfsMinGranularity, CfsTargetLatency * weight / (totalWeight + weight));
+}
+
+int
+FairQueue::getWeight(Thread* thread)
+{
+    return niceToWeight[max(-20, min(thread->getPriority(), 19)) + 20];
+}
@@ -0,0 +1,42 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-24 13:05:47
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 10:31:15
+ * @Description: 完全公平调度(CFS)。每个线程按权重累计虚拟运行时间vruntime(实际运行的tick * 1024 / 权重)，
+ *               就绪线程放在一个以vruntime为键的堆里，每次运行vruntime最小的线程，CPU时间按权重比例分配。
+ *               权重由优先级决定：优先级相当于Linux的nice值，每差一级权重约差1.25倍。
+ *               时间片是CfsTargetLatency按权重分给所有就绪线程的一份，但不少于CfsMinGranularity
+ */
+#ifndef FAIRQUEUE_H
+#define FAIRQUEUE_H
+
+#include "ReadyQueue.h"
+#include "ThreadHeap.h"
+
+#define CfsTargetLatency	(20 * TimerTicks)   //每个就绪线程在这段时间内都能运行一次
+#define CfsMinGranularity	TimerTicks
+#define CfsNiceZeroWeight	1024                //优先级0的权重
+
+class FairQueue : public ReadyQueue
+{
+    public:
+        FairQueue();
+
+        virtual void Append(Thread* thread);
+        virtual Thread* RemoveFront();
+        virtual bool IsEmpty() {return heap.IsEmpty();}
+        virtual void Apply(void (*func)(Thread*));
+        virtual void Reprioritize(Thread* thread);  //权重变了，totalWeight要换成新的权重
+
+        virtual void Charge(Thread* thread, int ticks);
+        virtual int getQuantum(Thread* thread);
+        virtual int getWeight(Thread* thread);
+
+    private:
+        ThreadHeap heap;
+        int totalWeight;                //就绪线程的权重之和，每个线程按入队时记在readyWeight中的权重计算
+        long long minVruntime;          //单调不减，刚醒来的线程的vruntime不能比它小太多
+};
+
+#endif	// FAIRQUEUE_H
@@ -0,0 +1,168 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-27 09:40:02
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-27 16:48:20
+ * @Description:
+ */
+#include "FairShareQueue.h"
+#include "main.h"
+
+UserShare::UserShare(int uid, int shares)
+{
+    this->uid = uid;
+    this->shares = shares;
+    vruntime = minVruntime = 0;
+    cpuTicks = 0;
+}
+
+FairShareQueue::FairShareQueue(char* shareList)
+{
+    users = new List<UserShare*>();
+    readyNums = 0;
+    minVruntime = 0;
+
+    for (char* item = shareList; item != NULL; )
+    {
+        char* colon = strchr(item, ':');
+        ASSERT(colon != NULL);
+        UserShare* user = getUser(atoi(item));
+        user->shares = atoi(colon + 1);
+        ASSERT(user->shares > 0);
+        item = strchr(colon, ',');
+        if (item != NULL)
+        {
+            item++;
+        }
+    }
+}
+
+FairShareQueue::~FairShareQueue()
+{
+    while (!users->IsEmpty())
+    {
+        delete users->RemoveFront();
+    }
+    delete users;
+}
+
+/**
+ * @description: 线程进入它的用户的就绪堆。用户原来没有就绪线程时，它的虚拟运行时间不能小于minVruntime，
+ *               线程的运行时间也不能小于用户的minVruntime，不运行的时候不能攒下份额
+ * @param {Thread* thread}
+ * @return:
+ */
+void
+FairShareQueue::Append(Thread* thread)
+{
+    UserShare* user = getUser(thread->getUid());
+
+    if (user->threads.IsEmpty())
+    {
+        user->vruntime = max(user->vruntime, minVruntime);
+    }
+    thread->vruntime = max(thread->vruntime, user->minVruntime);
+    user->threads.Insert(thread);
+    readyNums++;
+}
+
+/**
+ * @description: 在有就绪线程的用户中选虚拟运行时间最小的，再取出这个用户运行时间最少的线程
+ * @param none
+ * @return: 队列为空时返回NULL
+ */
+Thread*
+FairShareQueue::RemoveFront()
+{
+    UserShare* next = NULL;
+
+    ListIterator<UserShare*> iter(users);
+    for (; !iter.IsDone(); iter.Next())
+    {
+        UserShare* user = iter.Item();
+        if (!user->threads.IsEmpty() && (next == NULL || user->vruntime < next->vruntime))
+        {
+            next = user;
+        }
+    }
+    if (next == NULL)
+    {
+        return NULL;
+    }
+
+    Thread* thread = next->threads.RemoveMin();
+    readyNums--;
+    next->minVruntime = max(next->minVruntime, thread->vruntime);
+    minVruntime = max(minVruntime, next->vruntime);
+    return thread;
+}
+
+void
+FairShareQueue::Apply(void (*func)(Thread*))
+{
+    ListIterator<UserShare*> iter(users);
+    for (; !iter.IsDone(); iter.Next())
+    {
+        iter.Item()->threads.Apply(func);
+    }
+}
+
+void
+FairShareQueue::Charge(Thread* thread, int ticks)
+{
+    UserShare* user = getUser(thread->getUid());
+
+    user->vruntime += (long long)ticks * FairShareScale / user->shares;
+    user->cpuTicks += ticks;
+    thread->vruntime += ticks;
+}
+
+void
+FairShareQueue::PrintStatistics()
+{
+    int totalShares = 0, totalTicks = 0;
+
+    ListIterator<UserShare*> iter(users);
+    for (; !iter.IsDone(); iter.Next())
+    {
+        if (iter.Item()->cpuTicks > 0)
+        {
+            totalShares += iter.Item()->shares;
+            totalTicks += iter.Item()->cpuTicks;
+        }
+    }
+    if (totalTicks == 0)
+    {
+        return;
+    }
+
+    printf("Fair share: user, shares (%% of users that ran), CPU ticks (%%)\n");
+    ListIterator<UserShare*> userIter(users);
+    for (; !userIter.IsDone(); userIter.Next())
+    {
+        UserShare* user = userIter.Item();
+        if (user->cpuTicks > 0)
+        {
+            printf("  uid %d: %d (%.1f%%), %d (%.1f%%)\n", user->uid, user->shares,
+                   100.0 * user->shares / totalShares, user->cpuTicks,
+                   100.0 * user->cpuTicks / totalTicks);
+        }
+    }
+}
+
+UserShare*
+FairShareQueue::getUser(int uid)
+{
+    ListIterator<UserShare*> iter(users);
+    for (; !iter.IsDone(); iter.Next())
+    {
+        if (iter.Item()->uid == uid)
+        {
+            return iter.Item();
+        }
+    }
+
+    UserShare* user = new UserShare(uid, FairShareDefaultShares);
+    users->Append(user);
+    return user;
+}
@@ -0,0 +1,62 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-27 09:14:36
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-27 16:48:20
+ * @Description: 按用户的两级公平份额调度。第一级在用户(uid)之间按配置的份额分配CPU：
+ *               每个用户有自己的虚拟运行时间(运行的tick * FairShareScale / 份额)，每次选虚拟运行时间最小的、有就绪线程的用户；
+ *               第二级在这个用户的线程之间平分，选这个用户中运行时间最少的线程。
+ *               所以一个用户开再多的线程，得到的也只是它的份额。
+ *               份额用-sh uid:shares,uid:shares...配置，没有配置的用户是FairShareDefaultShares
+ */
+#ifndef FAIRSHAREQUEUE_H
+#define FAIRSHAREQUEUE_H
+
+#include "ReadyQueue.h"
+#include "ThreadHeap.h"
+#include "list.h"
+#include "stats.h"
+
+#define FairShareDefaultShares	100
+#define FairShareScale		(1 << 16)       //份额为FairShareScale的用户运行一个tick，虚拟运行时间加1
+#define FairShareQuantum	TimerTicks
+
+class UserShare
+{
+    public:
+        UserShare(int uid, int shares);
+
+        int uid;
+        int shares;
+        long long vruntime;             //用户的虚拟运行时间
+        long long minVruntime;          //用户中最近被调度的线程的运行时间，单调不减
+        int cpuTicks;                   //用户的线程一共运行的tick数
+        ThreadHeap threads;             //用户的就绪线程，按线程自己的运行时间排序
+};
+
+class FairShareQueue : public ReadyQueue
+{
+    public:
+        FairShareQueue(char* shareList);            //shareList形如"1:200,2:100"，NULL表示所有用户份额相同
+        ~FairShareQueue();
+
+        virtual void Append(Thread* thread);
+        virtual Thread* RemoveFront();
+        virtual bool IsEmpty() {return readyNums == 0;}
+        virtual void Apply(void (*func)(Thread*));
+
+        virtual void Charge(Thread* thread, int ticks);
+        virtual int getQuantum(Thread* thread) {return FairShareQuantum;}
+        virtual int getWeight(Thread* thread) {return getUser(thread->getUid())->shares;}
+
+        virtual void PrintStatistics();             //每个用户配置的份额和实际得到的CPU时间
+
+    private:
+        List<UserShare*>* users;
+        int readyNums;
+        long long minVruntime;          //最近被调度的用户的虚拟运行时间，单调不减
+
+        UserShare* getUser(int uid);    //没有见过的用户按默认份额加入
+};
+
+#endif	// FAIRSHAREQUEUE_H
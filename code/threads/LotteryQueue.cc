@@ -0,0 +1,83 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-25 13:31:05
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 15:12:09
+ * @Description:
+ */
+#include "LotteryQueue.h"
+#include "sysdep.h"
+
+LotteryQueue::LotteryQueue()
+{
+    head = tail = NULL;
+}
+
+void
+LotteryQueue::Append(Thread* thread)
+{
+    thread->nextReady = NULL;
+    if (tail == NULL)
+    {
+        head = thread;
+    }
+    else
+    {
+        tail->nextReady = thread;
+    }
+    tail = thread;
+}
+
+/**
+ * @description: 抽奖：在[0, 彩票总数)中随机取一个数，按链表顺序找到持有这张彩票的线程并摘下
+ * @param none
+ * @return: 中奖的线程，队列为空时返回NULL
+ */
+Thread*
+LotteryQueue::RemoveFront()
+{
+    int totalTickets = 0;
+
+    for (Thread* thread = head; thread != NULL; thread = thread->nextReady)
+    {
+        totalTickets += thread->getTickets();
+    }
+    if (totalTickets == 0)
+    {
+        return NULL;
+    }
+
+    int winner = RandomNumber() % totalTickets;
+    Thread* prev = NULL;
+    Thread* thread = head;
+    while (winner >= thread->getTickets())
+    {
+        winner -= thread->getTickets();
+        prev = thread;
+        thread = thread->nextReady;
+    }
+
+    if (prev == NULL)
+    {
+        head = thread->nextReady;
+    }
+    else
+    {
+        prev->nextReady = thread->nextReady;
+    }
+    if (tail == thread)
+    {
+        tail = prev;
+    }
+    thread->nextReady = NULL;
+    return thread;
+}
+
+void
+LotteryQueue::Apply(void (*func)(Thread*))
+{
+    for (Thread* thread = head; thread != NULL; thread = thread->nextReady)
+    {
+        func(thread);
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-25 13:20:48
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 15:12:09
+ * @Description: 彩票调度(Waldspurger & Weihl, 1994)。每次调度从所有就绪线程的彩票中随机抽一张，
+ *               持有这张彩票的线程运行一个时间片，长期来看CPU时间按彩票数的比例分配。
+ *               就绪线程用nextReady串成一个链表，抽奖时遍历两遍(先求和再找中奖者)，是O(n)的。
+ *               彩票数可以在线程就绪时修改，所以不缓存彩票总数
+ */
+#ifndef LOTTERYQUEUE_H
+#define LOTTERYQUEUE_H
+
+#include "ReadyQueue.h"
+#include "stats.h"
+
+#define LotteryQuantum	TimerTicks
+
+class LotteryQueue : public ReadyQueue
+{
+    public:
+        LotteryQueue();
+
+        virtual void Append(Thread* thread);
+        virtual Thread* RemoveFront();
+        virtual bool IsEmpty() {return head == NULL;}
+        virtual void Apply(void (*func)(Thread*));
+
+        virtual void Charge(Thread* thread, int ticks) {}
+        virtual int getQuantum(Thread* thread) {return LotteryQuantum;}
+        virtual int getWeight(Thread* thread) {return thread->getTickets();}
+
+    private:
+        Thread* head;
+        Thread* tail;
+};
+
+#endif	// LOTTERYQUEUE_H
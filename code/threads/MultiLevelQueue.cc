@@ -0,0 +1,247 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-23 10:30:51
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-29 14:12:40
+ * @Description:
+ */
+#include "MultiLevelQueue.h"
+#include "main.h"
+
+MultiLevelQueue::MultiLevelQueue(char* quantumList)
+{
+    int level = 0;
+
+    for (int i = 0; i < NumPriorityLevels; i++)
+    {
+        head[i] = tail[i] = NULL;
+        quantum[i] = 0;
+    }
+    nonEmptyLevels = 0;
+    boostEpoch = 0;
+    nextBoostTick = MlfqBoostInterval;
+
+    for (char* item = quantumList; item != NULL && level < NumPriorityLevels; level++)
+    {
+        quantum[level] = atoi(item);
+        ASSERT(quantum[level] > 0);
+        item = strchr(item, ',');
+        if (item != NULL)
+        {
+            item++;
+        }
+    }
+    for (; level > 0 && level < NumPriorityLevels; level++)
+    {
+        quantum[level] = quantum[level - 1];
+    }
+}
+
+/**
+ * @description: 线程进入就绪队列。上次提升时它在运行或者阻塞，先补上这次提升
+ * @param {Thread* thread}
+ * @return:
+ */
+void
+MultiLevelQueue::Append(Thread* thread)
+{
+    if (thread->boostEpoch != boostEpoch)
+    {
+        resetLevel(thread);
+    }
+    enqueue(thread, queueLevel(thread));
+}
+
+Thread*
+MultiLevelQueue::RemoveFront()
+{
+    if (kernel->stats->totalTicks >= nextBoostTick)
+    {
+        boost();
+    }
+    return dequeue();
+}
+
+void
+MultiLevelQueue::Apply(void (*func)(Thread*))
+{
+    for (int level = 0; level < NumPriorityLevels; level++)
+    {
+        for (Thread* thread = head[level]; thread != NULL; thread = thread->nextReady)
+        {
+            func(thread);
+        }
+    }
+}
+
+/**
+ * @description: 把线程从原来的队列中摘下，按现在的优先级重新排到队尾
+ * @param {Thread* thread}
+ * @return:
+ */
+void
+MultiLevelQueue::Reprioritize(Thread* thread)
+{
+    for (int level = 0; level < NumPriorityLevels; level++)
+    {
+        Thread* prev = NULL;
+        for (Thread* t = head[level]; t != NULL; prev = t, t = t->nextReady)
+        {
+            if (t != thread)
+            {
+                continue;
+            }
+            if (prev == NULL)
+            {
+                head[level] = t->nextReady;
+            }
+            else
+            {
+                prev->nextReady = t->nextReady;
+            }
+            if (tail[level] == t)
+            {
+                tail[level] = prev;
+            }
+            if (head[level] == NULL)
+            {
+                nonEmptyLevels &= ~(1u << level);
+            }
+            enqueue(thread, queueLevel(thread));
+            return;
+        }
+    }
+    ASSERTNOTREACHED();
+}
+
+/**
+ * @description: 正在运行的线程用完了时间片。到了提升的时间先提升，它自己也回到自己的优先级；
+ *               然后只有最高的非空级别不低于它排队的级别时才让出CPU
+ * @param {Thread* current}
+ * @return: 是否让出CPU
+ */
+bool
+MultiLevelQueue::ShouldPreempt(Thread* current)
+{
+    if (kernel->stats->totalTicks >= nextBoostTick)
+    {
+        boost();
+    }
+    if (current->boostEpoch != boostEpoch)
+    {
+        resetLevel(current);
+    }
+    return nonEmptyLevels != 0 && __builtin_ctz(nonEmptyLevels) <= queueLevel(current);
+}
+
+/**
+ * @description: 记录运行时间，在当前级别用完配额后降一级
+ * @param {Thread* thread, int ticks}
+ * @return:
+ */
+void
+MultiLevelQueue::Charge(Thread* thread, int ticks)
+{
+    thread->levelTicks += ticks;
+    if (thread->levelTicks >= MlfqAllotment(thread->level) && thread->level < NumPriorityLevels - 1)
+    {
+        thread->level++;
+        thread->levelTicks = 0;
+        DEBUG(dbgThread, "Demoting thread " << thread->getName() << " to level " << thread->level);
+    }
+}
+
+/**
+ * @description: 线程排在哪一级：反馈降到的级别；被捐赠了更高的优先级时，不低于被捐赠的优先级
+ * @param {Thread* thread}
+ * @return:
+ */
+int
+MultiLevelQueue::queueLevel(Thread* thread)
+{
+    if (thread->getPriority() < thread->getBasePriority())
+    {
+        return min(thread->level, max(0, min(thread->getPriority(), NumPriorityLevels - 1)));
+    }
+    return thread->level;
+}
+
+void
+MultiLevelQueue::enqueue(Thread* thread, int level)
+{
+    thread->nextReady = NULL;
+    if (tail[level] == NULL)
+    {
+        head[level] = thread;
+        nonEmptyLevels |= 1u << level;
+    }
+    else
+    {
+        tail[level]->nextReady = thread;
+    }
+    tail[level] = thread;
+}
+
+/**
+ * @description: 取出优先级最高的非空队列的第一个线程
+ * @param none
+ * @return: 队列为空时返回NULL
+ */
+Thread*
+MultiLevelQueue::dequeue()
+{
+    if (nonEmptyLevels == 0)
+    {
+        return NULL;
+    }
+
+    int level = __builtin_ctz(nonEmptyLevels);      //最低的置位
+    Thread* thread = head[level];
+
+    head[level] = thread->nextReady;
+    if (head[level] == NULL)
+    {
+        tail[level] = NULL;
+        nonEmptyLevels &= ~(1u << level);
+    }
+    thread->nextReady = NULL;
+    return thread;
+}
+
+void
+MultiLevelQueue::resetLevel(Thread* thread)
+{
+    thread->level = max(0, min(thread->getBasePriority(), NumPriorityLevels - 1));
+    thread->levelTicks = 0;
+    thread->boostEpoch = boostEpoch;
+}
+
+/**
+ * @description: 周期性的提升。就绪的线程马上回到自己的优先级，正在运行和阻塞的线程在下次进入就绪队列时回到自己的优先级
+ * @param none
+ * @return:
+ */
+void
+MultiLevelQueue::boost()
+{
+    Thread* boosted = NULL;
+    Thread** last = &boosted;
+
+    boostEpoch++;
+    nextBoostTick = kernel->stats->totalTicks + MlfqBoostInterval;
+
+    //先全部取出并保持顺序，否则放到更高级别的线程会被再次取出
+    while (nonEmptyLevels != 0)
+    {
+        *last = dequeue();
+        last = &(*last)->nextReady;
+    }
+    while (boosted != NULL)
+    {
+        Thread* thread = boosted;
+        boosted = thread->nextReady;
+        resetLevel(thread);
+        enqueue(thread, queueLevel(thread));
+    }
+    DEBUG(dbgThread, "Priority boost " << boostEpoch);
+}
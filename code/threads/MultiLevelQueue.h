@@ -0,0 +1,55 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-23 10:12:36
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-29 14:12:40
+ * @Description: 多级反馈队列。每个优先级一个FIFO队列，用线程自己的nextReady指针串起来，入队不需要分配链表节点；
+ *               一个位图记录哪些级别非空，出队时取最低的置位(数字越小优先级越高)，入队和出队都是O(1)。
+ *               线程从自己的优先级开始，在每一级用完MlfqAllotment(level)个tick后降一级，
+ *               每隔MlfqBoostInterval个tick所有线程回到自己的优先级，防止饥饿。
+ *               持有锁的线程被捐赠了更高的优先级时，至少在被捐赠的级别排队，不受降级影响。
+ *               打开时间片(-q)时每一级有自己的时间片长度，时间片只在同一级内轮转，不会让给更低的级别
+ */
+#ifndef MULTILEVELQUEUE_H
+#define MULTILEVELQUEUE_H
+
+#include "ReadyQueue.h"
+
+#define NumPriorityLevels 32            //位图正好是一个字
+
+#define MlfqAllotment(level)	(((level) + 1) * TimerTicks)
+#define MlfqBoostInterval	(100 * TimerTicks)
+
+class MultiLevelQueue : public ReadyQueue
+{
+    public:
+        MultiLevelQueue(char* quantumList);         //quantumList形如"100,200,400"，是第0、1、2...级的时间片，
+                                                    //之后的级别沿用最后一个值；NULL表示不使用时间片
+
+        virtual void Append(Thread* thread);
+        virtual Thread* RemoveFront();              //最高的非空级别的队首，到了提升的时间先提升
+        virtual bool IsEmpty() {return nonEmptyLevels == 0;}
+        virtual void Apply(void (*func)(Thread*));
+        virtual void Reprioritize(Thread* thread);
+        virtual bool ShouldPreempt(Thread* current);  //只有同级或更高级别有就绪线程时才轮转
+
+        virtual void Charge(Thread* thread, int ticks);
+        virtual int getQuantum(Thread* thread) {return quantum[queueLevel(thread)];}
+        virtual int getWeight(Thread* thread) {return 1;}
+
+    private:
+        Thread* head[NumPriorityLevels];
+        Thread* tail[NumPriorityLevels];
+        unsigned int nonEmptyLevels;    //第i位表示第i级非空
+        int quantum[NumPriorityLevels];
+        int boostEpoch;                 //已经提升过的次数
+        int nextBoostTick;
+
+        int queueLevel(Thread* thread);
+        void enqueue(Thread* thread, int level);
+        Thread* dequeue();
+        void resetLevel(Thread* thread);
+        void boost();
+};
+
+#endif	// MULTILEVELQUEUE_H
@@ -0,0 +1,69 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-29 09:22:41
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-29 14:05:18
+ * @Description: 以进程号为下标的表，线程表和地址空间表都用它，按进程号查找是O(1)的。
+ *               表的大小从initialSize开始，放入的进程号超出范围时按2的幂增长到能放下为止
+ */
+#ifndef PIDTABLE_H
+#define PIDTABLE_H
+
+#include "debug.h"
+
+template <class T>
+class PidTable
+{
+    public:
+        PidTable(int initialSize)
+        {
+            ASSERT(initialSize > 0);
+            size = initialSize;
+            table = new T[size];
+            for (int i = 0; i < size; i++)
+            {
+                table[i] = NULL;
+            }
+        }
+        ~PidTable() {delete[] table;}
+
+        T get(int pid) {return (pid >= 0 && pid < size) ? table[pid] : NULL;}
+        void set(int pid, T item)
+        {
+            ASSERT(pid >= 0);
+            if (pid >= size)
+            {
+                grow(pid + 1);
+            }
+            table[pid] = item;
+        }
+        void remove(int pid) {if (pid >= 0 && pid < size) table[pid] = NULL;}
+        int getSize() {return size;}    //进程号都小于它
+        void grow(int minSize)          //扩大到至少minSize项
+        {
+            int newSize = size;
+            while (newSize < minSize)
+            {
+                newSize *= 2;
+            }
+            if (newSize == size)
+            {
+                return;
+            }
+
+            T* newTable = new T[newSize];
+            for (int i = 0; i < newSize; i++)
+            {
+                newTable[i] = (i < size) ? table[i] : NULL;
+            }
+            delete[] table;
+            table = newTable;
+            size = newSize;
+        }
+
+    private:
+        T* table;
+        int size;
+};
+
+#endif	// PIDTABLE_H
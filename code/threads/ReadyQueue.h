@@ -0,0 +1,36 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-24 09:35:20
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-29 14:12:40
+ * @Description: 就绪队列，也就是调度策略。Scheduler只负责分派和计时，下一个运行哪个线程、
+ *               运行的时间怎么记账、时间片多长都由具体的就绪队列决定
+ */
+#ifndef READYQUEUE_H
+#define READYQUEUE_H
+
+#include "thread.h"
+
+class ReadyQueue
+{
+    public:
+        virtual ~ReadyQueue() {}
+
+        virtual void Append(Thread* thread) = 0;
+        virtual Thread* RemoveFront() = 0;                  //下一个运行的线程，没有就绪线程时返回NULL
+        virtual bool IsEmpty() = 0;
+        virtual void Apply(void (*func)(Thread*)) = 0;
+        virtual void Reprioritize(Thread* thread) {}       //就绪线程的getPriority()变了(优先级继承)，
+                                                            //按优先级排队的策略要把它挪到新的位置
+        virtual bool ShouldPreempt(Thread* current) {return !IsEmpty();}
+                                                            //current用完了时间片，是否要让给下一个就绪线程；
+                                                            //按优先级排队的策略只让给不比它低的线程
+
+        virtual void Charge(Thread* thread, int ticks) = 0; //正在运行的线程又用了ticks的CPU时间
+        virtual int getQuantum(Thread* thread) = 0;         //线程的时间片，0表示不抢占
+        virtual int getWeight(Thread* thread) = 0;          //按比例分配CPU时线程应得的份额，不按比例分配时为1
+
+        virtual void PrintStatistics() {}                   //关机时打印调度策略自己的统计
+};
+
+#endif	// READYQUEUE_H
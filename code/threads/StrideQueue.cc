@@ -0,0 +1,43 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-25 10:52:37
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 15:12:09
+ * @Description:
+ */
+#include "StrideQueue.h"
+
+StrideQueue::StrideQueue()
+{
+    globalPass = 0;
+}
+
+void
+StrideQueue::Append(Thread* thread)
+{
+    thread->vruntime = max(thread->vruntime, globalPass);
+    heap.Insert(thread);
+}
+
+/**
+ * @description: 取出行程最小的线程，行程相同时先入队的先运行
+ * @param none
+ * @return: 队列为空时返回NULL
+ */
+Thread*
+StrideQueue::RemoveFront()
+{
+    Thread* thread = heap.RemoveMin();
+
+    if (thread != NULL)
+    {
+        globalPass = max(globalPass, thread->vruntime);
+    }
+    return thread;
+}
+
+void
+StrideQueue::Charge(Thread* thread, int ticks)
+{
+    thread->vruntime += (long long)ticks * StrideOne / thread->getTickets();
+}
@@ -0,0 +1,41 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-25 10:40:22
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 15:12:09
+ * @Description: 步幅调度(Waldspurger & Weihl, 1995)。每个线程的步幅和它的彩票数成反比，
+ *               运行一个tick行程(pass，存在vruntime中)增加StrideOne / tickets，每次运行行程最小的线程，
+ *               CPU时间按彩票数的比例分配，误差不超过一个时间片，不依赖随机数。
+ *               按实际运行的tick记账，没用完时间片就阻塞的线程只增加它用掉的部分。
+ *               就绪线程的行程不小于globalPass，阻塞了很久的线程醒来后不能攒下的份额独占CPU
+ */
+#ifndef STRIDEQUEUE_H
+#define STRIDEQUEUE_H
+
+#include "ReadyQueue.h"
+#include "stats.h"
+#include "ThreadHeap.h"
+
+#define StrideOne	(1 << 20)           //一张彩票的线程运行一个tick的行程增量
+#define StrideQuantum	TimerTicks
+
+class StrideQueue : public ReadyQueue
+{
+    public:
+        StrideQueue();
+
+        virtual void Append(Thread* thread);
+        virtual Thread* RemoveFront();
+        virtual bool IsEmpty() {return heap.IsEmpty();}
+        virtual void Apply(void (*func)(Thread*)) {heap.Apply(func);}
+
+        virtual void Charge(Thread* thread, int ticks);
+        virtual int getQuantum(Thread* thread) {return StrideQuantum;}
+        virtual int getWeight(Thread* thread) {return thread->getTickets();}
+
+    private:
+        ThreadHeap heap;
+        long long globalPass;           //最近一次被调度的线程的行程，单调不减
+};
+
+#endif	// STRIDEQUEUE_H
@@ -0,0 +1,126 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-25 09:52:30
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 10:26:48
+ * @Description:
+ */
+#include "ThreadHeap.h"
+
+void
+ThreadHeap::Insert(Thread* thread)
+{
+    thread->nextReady = thread->childReady = NULL;
+    thread->readySeq = nextSeq++;
+    root = meld(root, thread);
+}
+
+Thread*
+ThreadHeap::RemoveMin()
+{
+    Thread* thread = root;
+
+    if (thread != NULL)
+    {
+        root = mergePairs(thread->childReady);
+        thread->childReady = NULL;
+    }
+    return thread;
+}
+
+void
+ThreadHeap::Apply(void (*func)(Thread*))
+{
+    applySubtree(root, func);
+}
+
+/**
+ * @description: a是否应该比b先出队：vruntime小的在前，相等时先插入的在前。序号回绕后用差的符号比较仍然正确
+ * @param {Thread* a, Thread* b}
+ * @return:
+ */
+bool
+ThreadHeap::before(Thread* a, Thread* b)
+{
+    if (a->vruntime != b->vruntime)
+    {
+        return a->vruntime < b->vruntime;
+    }
+    return (int)(a->readySeq - b->readySeq) < 0;
+}
+
+/**
+ * @description: 合并两个堆，排在后面的根成为另一个根的第一个子节点(见before)
+ * @param {Thread* a, Thread* b} 两个堆的根，兄弟指针会被覆盖
+ * @return: 新的根
+ */
+Thread*
+ThreadHeap::meld(Thread* a, Thread* b)
+{
+    if (a == NULL)
+    {
+        return b;
+    }
+    if (b == NULL)
+    {
+        return a;
+    }
+    if (before(b, a))
+    {
+        Thread* t = a;
+        a = b;
+        b = t;
+    }
+    b->nextReady = a->childReady;
+    a->childReady = b;
+    a->nextReady = NULL;
+    return a;
+}
+
+/**
+ * @description: 删除根之后合并它的子节点：先从左到右两两合并，再从右到左合并成一个堆，均摊O(log n)。
+ *               不用递归，内核线程的栈不大
+ * @param {Thread* first} 第一个子节点
+ * @return: 新的根
+ */
+Thread*
+ThreadHeap::mergePairs(Thread* first)
+{
+    Thread* pairs = NULL;               //第一遍合并的结果，逆序串起来
+    Thread* result = NULL;
+
+    while (first != NULL)
+    {
+        Thread* a = first;
+        Thread* b = a->nextReady;
+        if (b == NULL)
+        {
+            first = NULL;
+        }
+        else
+        {
+            first = b->nextReady;
+            a = meld(a, b);
+        }
+        a->nextReady = pairs;
+        pairs = a;
+    }
+
+    while (pairs != NULL)
+    {
+        Thread* next = pairs->nextReady;
+        result = meld(result, pairs);
+        pairs = next;
+    }
+    return result;
+}
+
+void
+ThreadHeap::applySubtree(Thread* thread, void (*func)(Thread*))
+{
+    for (; thread != NULL; thread = thread->nextReady)
+    {
+        func(thread);
+        applySubtree(thread->childReady, func);
+    }
+}
@@ -0,0 +1,36 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-25 09:40:13
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-25 10:26:48
+ * @Description: 以Thread::vruntime为键的配对堆，公平调度和步幅调度的就绪队列都用它。
+ *               节点就是线程本身，子节点用childReady、兄弟节点用nextReady串起来，入队不需要分配内存。
+ *               插入O(1)，删除最小值均摊O(log n)；键相等时按插入的序号比较，先插入的先出队
+ */
+#ifndef THREADHEAP_H
+#define THREADHEAP_H
+
+#include "thread.h"
+
+class ThreadHeap
+{
+    public:
+        ThreadHeap() {root = NULL; nextSeq = 0;}
+
+        void Insert(Thread* thread);
+        Thread* RemoveMin();            //堆为空时返回NULL
+        Thread* Min() {return root;}
+        bool IsEmpty() {return root == NULL;}
+        void Apply(void (*func)(Thread*));
+
+    private:
+        Thread* root;
+        unsigned int nextSeq;           //下一个插入的线程的序号
+
+        bool before(Thread* a, Thread* b);
+        Thread* meld(Thread* a, Thread* b);
+        Thread* mergePairs(Thread* first);
+        void applySubtree(Thread* thread, void (*func)(Thread*));
+};
+
+#endif	// THREADHEAP_H
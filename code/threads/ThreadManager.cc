@@ -2,19 +2,12 @@
  * @Author: Lollipop
  * @Date: 2019-11-12 15:32:49
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-13 21:14:40
+ * @LastEditTime: 2019-11-29 14:05:18
  * @Description: 
  */
 #include "ThreadManager.h"
 #include "main.h"
 
-bool threadIDComp(void *target, void *data)
-{
-    int threadId = ((Thread *)target)->getPid();
-
-    return (threadId == (int)data);
-}
-
 static void printThread(Thread* thread)
 {
     const char* status[5] = {"Created", "Running", "Ready", "Blocked", "Zombie"};
@@ -29,14 +22,17 @@ static void printThread(Thread* thread)
 ThreadManager::ThreadManager()
 {
     threadCnt = 0;
-    threadList = new List<Thread*>();
-    threadMap = new Bitmap(THREAD_COUNT_MAX);
+    threadTable = new PidTable<Thread*>(THREAD_TABLE_INIT);
+    nextPid = 0;
+    pooling = TRUE;
+    pooledThreads = NULL;
+    pooledCnt = 0;
 }
 
 ThreadManager::~ThreadManager()
 {
-    delete threadMap;
-    delete threadList;
+    setPooling(FALSE);
+    delete threadTable;
 }
 
 Thread*
@@ -44,19 +40,30 @@ ThreadManager::createThread(char* threadName, int uid)
 {
     Thread* newThread = NULL;
 
-    if (threadCnt + 1 < THREAD_COUNT_MAX)
+    int pid = generateThreadID();
+
+    if (pid != -1)
     {
         threadCnt++;
 
-        int pid = generateThreadID();
-        newThread = new Thread(threadName, uid, pid);
+        if (pooledThreads != NULL)
+        {
+            newThread = pooledThreads;
+            pooledThreads = newThread->nextReady;
+            pooledCnt--;
+            newThread->Recycle(threadName, uid, pid);
+        }
+        else
+        {
+            newThread = new Thread(threadName, uid, pid);
+        }
 
         if (threadCnt > 1)
         {
             kernel->currentThread->addChild(newThread);
         }
 
-        threadList->Append(newThread);
+        threadTable->set(pid, newThread);
     }
 
     return newThread; 
@@ -75,29 +82,62 @@ ThreadManager::deleteThread(Thread* thread)
     {
         threadCnt--;
         int pid = thread->getPid();
-        threadMap->Clear(pid);
-        threadList->Remove(thread);
+        threadTable->remove(pid);
+        thread->detachFamily();
 
-        delete thread;
+        if (pooling && pooledCnt < THREAD_POOL_MAX)
+        {
+            thread->nextReady = pooledThreads;
+            pooledThreads = thread;
+            pooledCnt++;
+        }
+        else
+        {
+            delete thread;
+        }
     }
 
 }
 
-int
-ThreadManager::generateThreadID()
+void
+ThreadManager::setPooling(bool pooling)
 {
-    return threadMap->FindAndSet();
+    this->pooling = pooling;
+    while (!pooling && pooledThreads != NULL)
+    {
+        Thread* thread = pooledThreads;
+        pooledThreads = thread->nextReady;
+        pooledCnt--;
+        delete thread;
+    }
 }
 
-Thread*
-ThreadManager::getThreadPtr(int pid)
+/**
+ * @description: 分配进程号：从nextPid开始循环找第一个空闲的。线程表超过一半满时先加倍，
+ *               所以平均只要看常数个表项，而且一个进程号释放后至少再分配表大小一半次才会轮到它
+ * @param none
+ * @return: 进程号，已经有THREAD_COUNT_MAX个线程时返回-1
+ */
+int
+ThreadManager::generateThreadID()
 {
-    if (!threadMap->Test(pid))
+    int size = threadTable->getSize();
+
+    if ((threadCnt + 1) * 2 > size && size < THREAD_COUNT_MAX)
     {
-        return NULL;
+        threadTable->grow(min(size * 2, THREAD_COUNT_MAX));
+        size = threadTable->getSize();
     }
-
-    return (Thread*)(threadList->findByComp(threadIDComp, (void*)pid));
+    for (int i = 0; i < size; i++)
+    {
+        int pid = (nextPid + i) % size;
+        if (threadTable->get(pid) == NULL)
+        {
+            nextPid = pid + 1;
+            return pid;
+        }
+    }
+    return -1;
 }
 
 void
@@ -107,5 +147,11 @@ ThreadManager::listThreadStatus()
 	printf(" ThreadID | ThreadName | UserID | Status \n"); 
 	printf(" -------- | ---------- | ------ | ------ \n");
 
-    threadList->Apply(printThread);
+    for (int pid = 0; pid < threadTable->getSize(); pid++)
+    {
+        if (threadTable->get(pid) != NULL)
+        {
+            printThread(threadTable->get(pid));
+        }
+    }
 }
\ No newline at end of file
@@ -2,17 +2,21 @@
  * @Author: Lollipop
  * @Date: 2019-11-12 15:28:45
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-13 00:19:46
- * @Description: 
+ * @LastEditTime: 2019-11-29 14:05:18
+ * @Description: 线程的创建和销毁。销毁的线程不释放，连同它的栈一起放进一个池里，
+ *               下次创建线程时直接回收使用，省去每次分配8K字的栈(还要mprotect两个保护页)和TCB的开销。
+ *               线程表以进程号为下标，随线程数增长。进程号从上一次分配的位置往后找空闲的，
+ *               刚释放的进程号要等一圈之后才会再被分配，以免被误认为还是原来的线程
  */
 #ifndef THREADMANAGER_H
 #define THREADMANAGER_H
 
-#include "list.h"
 #include "thread.h"
-#include "bitmap.h"
+#include "PidTable.h"
 
-#define THREAD_COUNT_MAX 128
+#define THREAD_COUNT_MAX 2048           //进程号的上限，进程号要放得下引用跟踪记录中11位的ASID
+#define THREAD_TABLE_INIT 128           //线程表的初始大小，线程数超过一半时加倍
+#define THREAD_POOL_MAX 32              //池里最多保留的线程数，多出来的直接释放
 
 class ThreadManager
 {
@@ -28,13 +32,19 @@ class ThreadManager
         int getThreadCnt() {return (threadCnt);}
 
         int generateThreadID();
+        void setPooling(bool pooling);  //关闭时清空线程池，之后销毁的线程直接释放
+        int getPooledCnt() {return pooledCnt;}
 
-        Thread* getThreadPtr(int pid);
+        Thread* getThreadPtr(int pid) {return threadTable->get(pid);}
+        int getMaxThreadId() {return threadTable->getSize();}   //所有进程号都小于它
 
     private:
-        List<Thread*>* threadList;
+        PidTable<Thread*>* threadTable;
         int threadCnt;
-        Bitmap* threadMap;
+        int nextPid;                    //下一次从这里开始找空闲的进程号
+        bool pooling;
+        Thread* pooledThreads;          //销毁的线程，用nextReady串起来
+        int pooledCnt;
 };
 
 #endif	// THREADMANAGER_H
\ No newline at end of file
@@ -2,14 +2,13 @@
  * @Author: Lollipop
  * @Date: 2019-11-13 20:22:20
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-13 20:22:20
+ * @LastEditTime: 2019-11-26 11:05:37
  * @Description: 
  */
 // alarm.cc
 //	Routines to use a hardware timer device to provide a
-//	software alarm clock.  For now, we just provide time-slicing.
-//
-//	Not completely implemented.
+//	software alarm clock: time-slicing, and sleeping for a given
+//	number of ticks.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -48,25 +47,66 @@ Alarm::Alarm(bool doRandom)
 //	was interrupted.
 //
 //	For now, just provide time-slicing.  Only need to time slice 
-//      if we're currently running something (in other words, not idle).
+//      if we're currently running something (in other words, not idle),
+//	and then only once the running thread has used up its quantum
+//	(see Scheduler::QuantumExpired).
 //----------------------------------------------------------------------
 
 void 
 Alarm::CallBack() 
 {
-    // Interrupt *interrupt = kernel->interrupt;
-    // Scheduler *scheduler = kernel->scheduler;
-    // Thread *current = kernel->currentThread;
-    // Thread *front = scheduler->FindNextToRun();
-    // MachineStatus status = interrupt->getStatus();
-    
-    // if (status != IdleMode) {
-    //     DEBUG(dbgThread,"*****CallBack*****");
-    //     interrupt->DumpState();
-    //     if (front->getPriority() < current->getPriority())
-    //     {
-    //         interrupt->YieldOnReturn();
-    //     }
-        
-    // }
+    Interrupt *interrupt = kernel->interrupt;
+    MachineStatus status = interrupt->getStatus();
+
+    if (status != IdleMode && kernel->scheduler->QuantumExpired()) {
+        interrupt->YieldOnReturn();
+    }
+}
+
+//----------------------------------------------------------------------
+// Wakeup
+//	A one-shot interrupt that puts a thread sleeping in WaitUntil
+//	back on the ready list.  It has its own interrupt, rather than
+//	waiting for the next timer tick, so that real-time threads start
+//	their jobs on time.
+//----------------------------------------------------------------------
+
+class Wakeup : public CallBackObj {
+  public:
+    Wakeup(Thread *t) { thread = t; }
+
+    void CallBack() {
+	Interrupt *interrupt = kernel->interrupt;
+
+	kernel->scheduler->ReadyToRun(thread);
+	if (interrupt->getStatus() != IdleMode
+	    && kernel->scheduler->EarlierDeadlineReady()) {
+	    kernel->stats->numPreemptions++;
+	    interrupt->YieldOnReturn();
+	}
+	delete this;		// scheduled once, called once
+    }
+
+  private:
+    Thread *thread;
+};
+
+//----------------------------------------------------------------------
+// Alarm::WaitUntil
+//	Put the current thread to sleep for "x" ticks.  Returns at once
+//	if "x" is not positive.
+//----------------------------------------------------------------------
+
+void
+Alarm::WaitUntil(int x)
+{
+    IntStatus oldLevel;
+
+    if (x <= 0) {
+	return;
+    }
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    kernel->interrupt->Schedule(new Wakeup(kernel->currentThread), x, TimerInt);
+    kernel->currentThread->Sleep(FALSE);
+    kernel->interrupt->SetLevel(oldLevel);
 }
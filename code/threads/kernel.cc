@@ -17,6 +17,7 @@
 #include "synchconsole.h"
 #include "synchdisk.h"
 #include "post.h"
+#include <time.h>
 
 //----------------------------------------------------------------------
 // Kernel::Kernel
@@ -30,8 +31,14 @@ Kernel::Kernel(int argc, char **argv)
     debugUserProg = FALSE;
     consoleIn = NULL;          // default is stdin
     consoleOut = NULL;         // default is stdout
+    traceFile = NULL;          // default is no reference trace
+    quantumList = NULL;        // default is no time slicing
+    shareList = NULL;          // default is equal shares
+    userStackSize = UserStackSize;
+    schedulingPolicy = SchedMLFQ;
     threadManager = NULL;
     memoryManager = NULL;
+    futexTable = NULL;
 #ifndef FILESYS_STUB
     formatFlag = FALSE;
 #endif
@@ -55,6 +62,40 @@ Kernel::Kernel(int argc, char **argv)
 	    ASSERT(i + 1 < argc);
 	    consoleOut = argv[i + 1];
 	    i++;
+	} else if (strcmp(argv[i], "-rt") == 0) {
+	    ASSERT(i + 1 < argc);
+	    traceFile = argv[i + 1];
+	    i++;
+	} else if (strcmp(argv[i], "-q") == 0) {
+	    ASSERT(i + 1 < argc);
+	    quantumList = argv[i + 1];
+	    i++;
+	} else if (strcmp(argv[i], "-sh") == 0) {
+	    ASSERT(i + 1 < argc);
+	    shareList = argv[i + 1];
+	    i++;
+	} else if (strcmp(argv[i], "-ss") == 0) {
+	    ASSERT(i + 1 < argc);
+	    userStackSize = atoi(argv[i + 1]);
+	    ASSERT(userStackSize >= PageSize);
+	    i++;
+	} else if (strcmp(argv[i], "-sp") == 0) {
+	    ASSERT(i + 1 < argc);
+	    if (strcmp(argv[i + 1], "mlfq") == 0) {
+	        schedulingPolicy = SchedMLFQ;
+	    } else if (strcmp(argv[i + 1], "cfs") == 0) {
+	        schedulingPolicy = SchedCFS;
+	    } else if (strcmp(argv[i + 1], "stride") == 0) {
+	        schedulingPolicy = SchedStride;
+	    } else if (strcmp(argv[i + 1], "lottery") == 0) {
+	        schedulingPolicy = SchedLottery;
+	    } else if (strcmp(argv[i + 1], "share") == 0) {
+	        schedulingPolicy = SchedShare;
+	    } else {
+	        cout << "Unknown scheduling policy " << argv[i + 1] << "\n";
+	        Abort();
+	    }
+	    i++;
 #ifndef FILESYS_STUB
 	} else if (strcmp(argv[i], "-f") == 0) {
 	    formatFlag = TRUE;
@@ -71,6 +112,11 @@ Kernel::Kernel(int argc, char **argv)
             cout << "Partial usage: nachos [-rs randomSeed]\n";
 	    cout << "Partial usage: nachos [-s]\n";
             cout << "Partial usage: nachos [-ci consoleIn] [-co consoleOut]\n";
+            cout << "Partial usage: nachos [-rt traceFile]\n";
+            cout << "Partial usage: nachos [-q quantum,quantum,...]\n";
+            cout << "Partial usage: nachos [-sp mlfq|cfs|stride|lottery|share]\n";
+            cout << "Partial usage: nachos [-sh uid:shares,uid:shares,...]\n";
+            cout << "Partial usage: nachos [-ss stackSize]\n";
 #ifndef FILESYS_STUB
 	    cout << "Partial usage: nachos [-nf]\n";
 #endif
@@ -98,9 +144,13 @@ Kernel::Initialize()
 
     stats = new Statistics();		// collect statistics
     interrupt = new Interrupt;		// start up interrupt handling
-    scheduler = new Scheduler();	// initialize the ready queue
+    scheduler = new Scheduler(schedulingPolicy, quantumList, shareList);
+					// initialize the ready queue
     alarm = new Alarm(randomSlice);	// start up time slicing，这里相当于设置好了时钟中断机制
     machine = new Machine(debugUserProg);
+    if (traceFile != NULL) {
+        machine->referenceTrace = new ReferenceTrace(traceFile);
+    }
     synchConsoleIn = new SynchConsoleInput(consoleIn); // input from stdin
     synchConsoleOut = new SynchConsoleOutput(consoleOut); // output to stdout
     synchDisk = new SynchDisk();    //
@@ -112,6 +162,7 @@ Kernel::Initialize()
     postOfficeIn = new PostOfficeInput(10);
     postOfficeOut = new PostOfficeOutput(reliability);
     memoryManager = new MemoryManager();
+    futexTable = new FutexTable();
     interrupt->Enable();
 }
 
@@ -135,6 +186,7 @@ Kernel::~Kernel()
     delete postOfficeOut;
     delete threadManager;
     delete memoryManager;
+    delete futexTable;
     Exit(0);
 }
 
@@ -166,6 +218,673 @@ Kernel::ThreadSelfTest() {
 
 }
 
+//----------------------------------------------------------------------
+// Kernel::TranslateBenchmark
+//      Time Machine::Translate on a page table much larger than the
+//	TLB, striding through it so that most lookups walk the table.
+//	Reports translations per second and the size of one page table
+//	entry.
+//
+//	Only the current entry layout is timed; there is no old layout
+//	to compare against.  With USE_TLB every lookup misses and
+//	Translate refills the TLB through tlbManager->update, so the
+//	figure is dominated by the refill rather than by the page table
+//	walk.
+//----------------------------------------------------------------------
+
+void
+Kernel::TranslateBenchmark() {
+    const int numPages = 4096;
+    const int rounds = 256;
+    int pid = currentThread->getPid();
+    PageTable *savedTable = machine->pageTable;
+    PageTable *table = new PageTable(pid, numPages);
+    int physAddr;
+    unsigned int checksum = 0;
+
+    for (int vpn = 0; vpn < numPages; vpn++) {
+        TranslationEntry *entry = table->getEntry(vpn);
+        entry->setPhysicalPage(vpn % NumPhysPages);
+        entry->setValid(TRUE);
+    }
+    machine->pageTable = table;
+
+    clock_t start = clock();
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < numPages; i++) {
+            int vpn = (i * 97) % numPages;	// 97 is odd, so every page is hit
+            ASSERT(machine->Translate(vpn * PageSize, &physAddr, 4,
+                                      (round & 1) != 0) == NoException);
+            checksum += physAddr;
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    cout << "Translate benchmark: " << numPages * rounds << " translations in "
+         << seconds << " s";
+    if (seconds > 0) {
+        cout << " (" << (int)(numPages * rounds / seconds) << " per second)";
+    }
+    cout << ", " << sizeof(TranslationEntry) << " bytes per page table entry"
+         << ", checksum " << checksum << "\n";
+
+#ifdef USE_TLB
+    for (int vpn = 0; vpn < numPages; vpn++) {
+        machine->tlbManager->invalidEntry(pid, vpn);
+    }
+#endif
+    machine->pageTable = savedTable;
+    delete table;
+}
+
+//----------------------------------------------------------------------
+// Kernel::FairnessBenchmark
+//      Run CPU-bound kernel threads of different priorities and
+//	tickets side by side for a fixed stretch of simulated time, and
+//	compare the share of the CPU each one got with the share the
+//	scheduling policy means to give it (its weight over the total:
+//	priority decides the weight under cfs, tickets under stride and
+//	lottery).  Jain's index of achieved over intended share is 1.0
+//	when the shares are exactly proportional.  Needs time slicing
+//	(always on except under mlfq without "-q") to be meaningful.
+//----------------------------------------------------------------------
+
+struct FairnessSpinner {
+    int endTick;		// stop spinning at this time
+    int cpuTicks;		// CPU time the thread got
+    Semaphore *done;
+};
+
+static void
+SpinUntil(void *arg)
+{
+    FairnessSpinner *spinner = (FairnessSpinner *)arg;
+
+    while (kernel->stats->totalTicks < spinner->endTick) {
+        kernel->interrupt->SetLevel(IntOff);	// each turn costs a
+        kernel->interrupt->SetLevel(IntOn);	// tick of kernel time
+    }
+    spinner->cpuTicks = kernel->currentThread->cpuTicks;
+    spinner->done->V();
+}
+
+void
+Kernel::FairnessBenchmark() {
+    const int numThreads = 6;
+    const int priorities[numThreads] = { 0, 0, 0, 1, 3, 5 };
+    const int tickets[numThreads] = { 100, 100, 100, 200, 300, 400 };
+    const int runTicks = 200000;
+    char *names[numThreads] = { "spin 0", "spin 1", "spin 2", "spin 3", "spin 4", "spin 5" };
+    FairnessSpinner spinners[numThreads];
+    int weights[numThreads];
+    int totalWeight = 0, totalTicks = 0;
+    Semaphore *done = new Semaphore("fairness benchmark", 0);
+    int endTick = stats->totalTicks + runTicks;
+
+    for (int i = 0; i < numThreads; i++) {
+        Thread *t = threadManager->createThread(names[i]);
+        ASSERT(t != NULL);
+        t->setPriority(priorities[i]);
+        t->setTickets(tickets[i]);
+        weights[i] = scheduler->getWeight(t);
+        totalWeight += weights[i];
+        spinners[i].endTick = endTick;
+        spinners[i].done = done;
+        t->Fork(SpinUntil, &spinners[i]);
+    }
+    for (int i = 0; i < numThreads; i++) {
+        done->P();
+    }
+    delete done;
+
+    for (int i = 0; i < numThreads; i++) {
+        totalTicks += spinners[i].cpuTicks;
+    }
+    double sum = 0, sumSquares = 0;
+    cout << "Fairness benchmark: " << numThreads << " threads, "
+         << runTicks << " ticks\n";
+    cout << "thread priority tickets weight  share(%) intended(%)\n";
+    for (int i = 0; i < numThreads; i++) {
+        double share = 100.0 * spinners[i].cpuTicks / totalTicks;
+        double intended = 100.0 * weights[i] / totalWeight;
+        printf("%6d %8d %7d %6d %9.2f %11.2f\n", i, priorities[i], tickets[i],
+               weights[i], share, intended);
+        sum += share / intended;
+        sumSquares += (share / intended) * (share / intended);
+    }
+    cout << "Jain's fairness index " << sum * sum / (numThreads * sumSquares)
+         << ", " << stats->numContextSwitches << " context switches\n";
+}
+
+//----------------------------------------------------------------------
+// Kernel::RealTimeBenchmark
+//      Run periodic real-time "device handler" threads next to
+//	CPU-bound best-effort threads, and report for each handler how
+//	many jobs finished past their deadline and the worst response
+//	time (from the start of a period to the end of its job).  Also
+//	checks that admission control turns away a reservation that
+//	would overload the CPU.
+//----------------------------------------------------------------------
+
+struct RealTimeDevice {
+    int period;			// ticks between job releases
+    int budget;			// CPU ticks reserved per period
+    int work;			// CPU ticks each job takes
+    int jobs;			// number of jobs to run
+    int misses;			// jobs that finished late
+    int worstResponse;		// longest release-to-finish time
+    Semaphore *done;
+};
+
+static void
+DeviceHandler(void *arg)
+{
+    RealTimeDevice *device = (RealTimeDevice *)arg;
+    Thread *self = kernel->currentThread;
+
+    for (int job = 0; job < device->jobs; job++) {
+        int release = self->rtJobDeadline - self->rtPeriod;
+
+        for (int i = 0; i < device->work / SystemTick; i++) {
+            kernel->interrupt->SetLevel(IntOff);
+            kernel->interrupt->SetLevel(IntOn);
+        }
+        if (kernel->stats->totalTicks > self->rtJobDeadline) {
+            device->misses++;
+        }
+        device->worstResponse = max(device->worstResponse, kernel->stats->totalTicks - release);
+        kernel->scheduler->WaitNextPeriod();
+    }
+    kernel->scheduler->SetRealTime(self, 0, 0);
+    device->done->V();
+}
+
+void
+Kernel::RealTimeBenchmark() {
+    const int numDevices = 3, numSpinners = 3;
+    const int runTicks = 100000;
+    RealTimeDevice devices[numDevices] = {
+        { 1000, 300, 200 }, { 2500, 600, 500 }, { 5000, 1500, 1000 }
+    };
+    char *deviceNames[numDevices] = { "device 0", "device 1", "device 2" };
+    char *spinnerNames[numSpinners] = { "background 0", "background 1", "background 2" };
+    FairnessSpinner spinners[numSpinners];
+    Semaphore *done = new Semaphore("real-time benchmark", 0);
+    int endTick = stats->totalTicks + runTicks;
+
+    for (int i = 0; i < numSpinners; i++) {
+        Thread *t = threadManager->createThread(spinnerNames[i]);
+        ASSERT(t != NULL);
+        spinners[i].endTick = endTick;
+        spinners[i].done = done;
+        t->Fork(SpinUntil, &spinners[i]);
+    }
+    for (int i = 0; i < numDevices; i++) {
+        Thread *t = threadManager->createThread(deviceNames[i]);
+        ASSERT(t != NULL);
+        devices[i].jobs = runTicks / devices[i].period;
+        devices[i].misses = devices[i].worstResponse = 0;
+        devices[i].done = done;
+        if (!scheduler->SetRealTime(t, devices[i].period, devices[i].budget)) {
+            cout << "Reservation of " << deviceNames[i] << " refused\n";
+            Abort();
+        }
+        t->Fork(DeviceHandler, &devices[i]);
+    }
+
+    if (scheduler->SetRealTime(currentThread, 1000, 200)) {
+        cout << "A further 200/1000 reservation was wrongly admitted\n";
+        scheduler->SetRealTime(currentThread, 0, 0);
+    } else {
+        cout << "A further 200/1000 reservation was refused\n";
+    }
+
+    for (int i = 0; i < numDevices + numSpinners; i++) {
+        done->P();
+    }
+    delete done;
+
+    cout << "Real-time benchmark: " << numDevices << " device threads, "
+         << numSpinners << " CPU-bound threads, " << runTicks << " ticks\n";
+    cout << "device period budget work jobs misses worst response\n";
+    for (int i = 0; i < numDevices; i++) {
+        printf("%6d %6d %6d %4d %4d %6d %14d\n", i, devices[i].period,
+               devices[i].budget, devices[i].work, devices[i].jobs,
+               devices[i].misses, devices[i].worstResponse);
+    }
+}
+
+//----------------------------------------------------------------------
+// Kernel::FairShareBenchmark
+//      Three users run 1, 4 and 2 CPU-bound threads for a fixed
+//	stretch of simulated time.  Print the share of the CPU each
+//	user got next to the share of its weight (its configured shares
+//	under "-sp share"; under policies that weigh threads rather than
+//	users it is the weight of one of its threads, so the intended
+//	split is whatever each user would get with a single thread).
+//----------------------------------------------------------------------
+
+void
+Kernel::FairShareBenchmark() {
+    const int numUsers = 3, numThreads = 7;
+    const int uids[numThreads] = { 1, 2, 2, 2, 2, 3, 3 };
+    const int runTicks = 200000;
+    char *names[numThreads] = { "user 1", "user 2", "user 2", "user 2", "user 2", "user 3", "user 3" };
+    FairnessSpinner spinners[numThreads];
+    int userWeights[numUsers], userTicks[numUsers];
+    int totalWeight = 0, totalTicks = 0;
+    Semaphore *done = new Semaphore("fair share benchmark", 0);
+    int endTick = stats->totalTicks + runTicks;
+
+    for (int u = 0; u < numUsers; u++) {
+        userWeights[u] = userTicks[u] = 0;
+    }
+    for (int i = 0; i < numThreads; i++) {
+        Thread *t = threadManager->createThread(names[i], uids[i]);
+        ASSERT(t != NULL);
+        userWeights[uids[i] - 1] = scheduler->getWeight(t);
+        spinners[i].endTick = endTick;
+        spinners[i].done = done;
+        t->Fork(SpinUntil, &spinners[i]);
+    }
+    for (int i = 0; i < numThreads; i++) {
+        done->P();
+    }
+    delete done;
+
+    for (int i = 0; i < numThreads; i++) {
+        userTicks[uids[i] - 1] += spinners[i].cpuTicks;
+        totalTicks += spinners[i].cpuTicks;
+    }
+    for (int u = 0; u < numUsers; u++) {
+        totalWeight += userWeights[u];
+    }
+    cout << "Fair share benchmark: " << numUsers << " users, "
+         << numThreads << " threads, " << runTicks << " ticks\n";
+    cout << "  uid threads weight  share(%) intended(%)\n";
+    for (int u = 0; u < numUsers; u++) {
+        int threads = 0;
+        for (int i = 0; i < numThreads; i++) {
+            threads += (uids[i] == u + 1);
+        }
+        printf("%5d %7d %6d %9.2f %11.2f\n", u + 1, threads, userWeights[u],
+               100.0 * userTicks[u] / totalTicks, 100.0 * userWeights[u] / totalWeight);
+    }
+}
+
+//----------------------------------------------------------------------
+// Kernel::ForkJoinBenchmark
+//      Time (in host CPU time) forking short-lived threads and waiting
+//	for them to finish, first with the thread pool turned off, so
+//	that every thread gets a new control block and stack, then with
+//	it on.  Each round forks a batch of threads so that some are
+//	alive at the same time, as in a real fork/join workload.
+//----------------------------------------------------------------------
+
+static void
+SignalDone(void *arg)
+{
+    ((Semaphore *)arg)->V();
+}
+
+void
+Kernel::ForkJoinBenchmark() {
+    const int rounds = 2000, batch = 8;
+    double seconds[2];
+    Semaphore *done = new Semaphore("fork/join benchmark", 0);
+
+    for (int pooled = 0; pooled < 2; pooled++) {
+        threadManager->setPooling(pooled);
+        clock_t start = clock();
+        for (int round = 0; round < rounds; round++) {
+            for (int i = 0; i < batch; i++) {
+                Thread *t = threadManager->createThread("fork/join");
+                ASSERT(t != NULL);
+                t->Fork(SignalDone, done);
+            }
+            for (int i = 0; i < batch; i++) {
+                done->P();
+            }
+        }
+        seconds[pooled] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }
+    delete done;
+
+    cout << "Fork/join benchmark: " << rounds * batch << " threads, "
+         << seconds[0] << " s without the thread pool, " << seconds[1] << " s with it";
+    if (seconds[1] > 0) {
+        cout << " (" << seconds[0] / seconds[1] << " times faster)";
+    }
+    cout << "\n";
+}
+
+//----------------------------------------------------------------------
+// Kernel::PriorityInversionBenchmark
+//      The classic priority inversion: a low-priority thread holds a
+//	lock, CPU-bound medium-priority threads are ready, and then a
+//	high-priority thread (here the main thread) asks for the lock.
+//	Report how long the high-priority thread waits for the lock.
+//	With priority inheritance the holder runs at high priority until
+//	it releases the lock, so the wait stays close to the time the
+//	holder still needs the lock for, whatever the medium threads do.
+//	Meant for the priority-ordered mlfq policy.
+//----------------------------------------------------------------------
+
+struct InversionHolder {
+    Lock *lock;
+    int holdTicks;		// CPU time spent holding the lock
+    Semaphore *acquired;	// signalled once the lock is held
+    Semaphore *done;
+};
+
+static void
+HoldLock(void *arg)
+{
+    InversionHolder *holder = (InversionHolder *)arg;
+
+    holder->lock->Acquire();
+    holder->acquired->V();
+    for (int i = 0; i < holder->holdTicks / SystemTick; i++) {
+        kernel->interrupt->SetLevel(IntOff);
+        kernel->interrupt->SetLevel(IntOn);
+    }
+    holder->lock->Release();
+    holder->done->V();
+}
+
+void
+Kernel::PriorityInversionBenchmark() {
+    const int rounds = 5, numSpinners = 3;
+    const int lowPriority = 8, mediumPriority = 4, highPriority = 0;
+    const int holdTicks = 500, spinTicks = 20000;
+    char *spinnerNames[numSpinners] = { "medium 0", "medium 1", "medium 2" };
+    FairnessSpinner spinners[numSpinners];
+    InversionHolder holder;
+    int oldPriority = currentThread->getBasePriority();
+    int totalWait = 0, worstWait = 0;
+
+    holder.lock = new Lock("inversion benchmark");
+    holder.holdTicks = holdTicks;
+    holder.acquired = new Semaphore("lock acquired", 0);
+    holder.done = new Semaphore("inversion benchmark", 0);
+    currentThread->setPriority(highPriority);
+
+    for (int round = 0; round < rounds; round++) {
+        Thread *t = threadManager->createThread("low");
+        ASSERT(t != NULL);
+        t->setPriority(lowPriority);
+        t->Fork(HoldLock, &holder);
+        holder.acquired->P();
+
+        for (int i = 0; i < numSpinners; i++) {
+            t = threadManager->createThread(spinnerNames[i]);
+            ASSERT(t != NULL);
+            t->setPriority(mediumPriority);
+            spinners[i].endTick = stats->totalTicks + spinTicks;
+            spinners[i].done = holder.done;
+            t->Fork(SpinUntil, &spinners[i]);
+        }
+
+        int start = stats->totalTicks;
+        holder.lock->Acquire();
+        int wait = stats->totalTicks - start;
+        holder.lock->Release();
+        totalWait += wait;
+        worstWait = max(worstWait, wait);
+
+        for (int i = 0; i < numSpinners + 1; i++) {
+            holder.done->P();
+        }
+    }
+    currentThread->setPriority(oldPriority);
+    delete holder.lock;
+    delete holder.acquired;
+    delete holder.done;
+
+    cout << "Priority inversion benchmark: " << rounds << " rounds, lock held for "
+         << holdTicks << " ticks, " << numSpinners << " medium-priority threads\n";
+    cout << "High-priority wait for the lock: mean " << totalWait / rounds
+         << " ticks, worst " << worstWait << " ticks\n";
+}
+
+//----------------------------------------------------------------------
+// Kernel::SyncBenchmark
+//      Microbenchmarks of the synchronization primitives, each reported
+//	in simulated ticks and host nanoseconds per operation:
+//	    semaphore ping-pong -- a round trip between two threads
+//	    lock handoff -- a lock passed back and forth between two
+//		threads that both want it
+//	    condition broadcast -- from a Broadcast until every waiter
+//		holds the lock once more
+//	    rwlock read scaling -- readers that keep the lock across a
+//		blocking wait (as for a disk read), under a Lock, a
+//		writer-preferring RWLock and a fair RWLock, for growing
+//		numbers of readers.  Only the RWLocks let the waits overlap.
+//----------------------------------------------------------------------
+
+static void
+PrintSyncResult(char *test, int ops, int ticks, clock_t host)
+{
+    printf("%-34s %8d %12.1f %12.1f\n", test, ops, (double)ticks / ops,
+           (double)host * 1e9 / CLOCKS_PER_SEC / ops);
+}
+
+struct PingPong {
+    Semaphore *ping, *pong;
+    int rounds;
+};
+
+static void
+Pong(void *arg)
+{
+    PingPong *p = (PingPong *)arg;
+
+    for (int i = 0; i < p->rounds; i++) {
+        p->ping->P();
+        p->pong->V();
+    }
+}
+
+struct Handoff {
+    Lock *lock;
+    int rounds;
+    Semaphore *done;
+};
+
+static void
+TakeTurns(void *arg)
+{
+    Handoff *h = (Handoff *)arg;
+
+    for (int i = 0; i < h->rounds; i++) {
+        h->lock->Acquire();
+        kernel->currentThread->Yield();	// the other thread blocks on
+        h->lock->Release();		// the lock, then gets it while
+        kernel->currentThread->Yield();	// we yield again
+    }
+    h->done->V();
+}
+
+struct BroadcastTest {
+    Lock *lock;
+    Condition *wake;		// waiters wait for the next round
+    Condition *allReady;	// main waits for all to be waiting
+    Condition *allWoken;	// main waits for all to have woken
+    int round, ready, woken;
+    int waiters, rounds;
+    Semaphore *done;
+};
+
+static void
+WaitForBroadcast(void *arg)
+{
+    BroadcastTest *b = (BroadcastTest *)arg;
+
+    b->lock->Acquire();
+    for (int myRound = 0; myRound < b->rounds; myRound++) {
+        if (++b->ready == b->waiters) {
+            b->allReady->Signal(b->lock);
+        }
+        while (b->round == myRound) {
+            b->wake->Wait(b->lock);
+        }
+        if (++b->woken == b->waiters) {
+            b->allWoken->Signal(b->lock);
+        }
+    }
+    b->lock->Release();
+    b->done->V();
+}
+
+struct ReadScaling {
+    Lock *lock;			// NULL to use rwlock
+    RWLock *rwlock;
+    int rounds;
+    int holdTicks;		// blocked while holding the lock
+    Barrier *barrier;		// start and finish together
+};
+
+static void
+Read(void *arg)
+{
+    ReadScaling *r = (ReadScaling *)arg;
+
+    r->barrier->Wait();
+    for (int i = 0; i < r->rounds; i++) {
+        if (r->lock != NULL) {
+            r->lock->Acquire();
+        } else {
+            r->rwlock->AcquireRead();
+        }
+        kernel->alarm->WaitUntil(r->holdTicks);
+        if (r->lock != NULL) {
+            r->lock->Release();
+        } else {
+            r->rwlock->ReleaseRead();
+        }
+    }
+    r->barrier->Wait();
+}
+
+void
+Kernel::SyncBenchmark() {
+    const int rounds = 10000;
+    int startTicks;
+    clock_t startClock;
+
+    cout << "Synchronization benchmark\n";
+    printf("%-34s %8s %12s %12s\n", "test", "ops", "ticks/op", "ns/op");
+
+    PingPong p;
+    p.ping = new Semaphore("ping", 0);
+    p.pong = new Semaphore("pong", 0);
+    p.rounds = rounds;
+    Thread *t = threadManager->createThread("pong");
+    ASSERT(t != NULL);
+    t->Fork(Pong, &p);
+    startTicks = stats->totalTicks;
+    startClock = clock();
+    for (int i = 0; i < rounds; i++) {
+        p.ping->V();
+        p.pong->P();
+    }
+    PrintSyncResult("semaphore ping-pong", rounds,
+                    stats->totalTicks - startTicks, clock() - startClock);
+    delete p.ping;
+    delete p.pong;
+
+    Handoff h;
+    h.lock = new Lock("handoff");
+    h.rounds = rounds;
+    h.done = new Semaphore("handoff done", 0);
+    startTicks = stats->totalTicks;
+    startClock = clock();
+    for (int i = 0; i < 2; i++) {
+        t = threadManager->createThread("handoff");
+        ASSERT(t != NULL);
+        t->Fork(TakeTurns, &h);
+    }
+    h.done->P();
+    h.done->P();
+    PrintSyncResult("lock handoff", 2 * rounds,
+                    stats->totalTicks - startTicks, clock() - startClock);
+    delete h.lock;
+    delete h.done;
+
+    BroadcastTest b;
+    int broadcastTicks = 0;
+    clock_t broadcastClock = 0;
+    b.lock = new Lock("broadcast");
+    b.wake = new Condition("wake");
+    b.allReady = new Condition("all ready");
+    b.allWoken = new Condition("all woken");
+    b.round = b.ready = b.woken = 0;
+    b.waiters = 8;
+    b.rounds = rounds / b.waiters;
+    b.done = new Semaphore("broadcast done", 0);
+    for (int i = 0; i < b.waiters; i++) {
+        t = threadManager->createThread("waiter");
+        ASSERT(t != NULL);
+        t->Fork(WaitForBroadcast, &b);
+    }
+    b.lock->Acquire();
+    for (int i = 0; i < b.rounds; i++) {
+        while (b.ready < b.waiters) {
+            b.allReady->Wait(b.lock);
+        }
+        b.ready = b.woken = 0;
+        startTicks = stats->totalTicks;
+        startClock = clock();
+        b.round++;
+        b.wake->Broadcast(b.lock);
+        while (b.woken < b.waiters) {
+            b.allWoken->Wait(b.lock);
+        }
+        broadcastTicks += stats->totalTicks - startTicks;
+        broadcastClock += clock() - startClock;
+    }
+    b.lock->Release();
+    for (int i = 0; i < b.waiters; i++) {
+        b.done->P();
+    }
+    PrintSyncResult("condition broadcast, 8 waiters", b.rounds,
+                    broadcastTicks, broadcastClock);
+    delete b.lock;
+    delete b.wake;
+    delete b.allReady;
+    delete b.allWoken;
+    delete b.done;
+
+    char *kinds[3] = { "lock", "rwlock", "fair rwlock" };
+    for (int kind = 0; kind < 3; kind++) {
+        for (int readers = 1; readers <= 8; readers *= 2) {
+            ReadScaling r;
+            char test[64];
+            r.lock = (kind == 0) ? new Lock("read scaling") : NULL;
+            r.rwlock = (kind == 0) ? NULL : new RWLock("read scaling", kind == 2);
+            r.rounds = rounds / 100;
+            r.holdTicks = 100;
+            r.barrier = new Barrier("read scaling", readers + 1);
+            for (int i = 0; i < readers; i++) {
+                t = threadManager->createThread("reader");
+                ASSERT(t != NULL);
+                t->Fork(Read, &r);
+            }
+            r.barrier->Wait();
+            startTicks = stats->totalTicks;
+            startClock = clock();
+            r.barrier->Wait();
+            sprintf(test, "%s read, %d reader%s", kinds[kind], readers,
+                    readers == 1 ? "" : "s");
+            PrintSyncResult(test, readers * r.rounds,
+                            stats->totalTicks - startTicks, clock() - startClock);
+            delete r.lock;
+            delete r.rwlock;
+            delete r.barrier;
+        }
+    }
+}
+
 //----------------------------------------------------------------------
 // Kernel::ConsoleTest
 //      Test the synchconsole
@@ -27,6 +27,7 @@
 #include "machine.h"
 #include "ThreadManager.h"
 #include "MemoryManager.h"
+#include "FutexTable.h"
 
 class PostOfficeInput;
 class PostOfficeOutput;
@@ -49,6 +50,20 @@ class Kernel {
     void ConsoleTest();         // interactive console self test
 
     void NetworkTest();         // interactive 2-machine network test
+
+    void TranslateBenchmark();  // time Machine::Translate over a big page table
+
+    void FairnessBenchmark();   // CPU shares of competing threads
+
+    void RealTimeBenchmark();   // deadlines of EDF threads under load
+
+    void FairShareBenchmark();  // CPU shares of users with many threads
+
+    void ForkJoinBenchmark();   // time thread creation and destruction
+
+    void PriorityInversionBenchmark();  // lock wait of a high-priority thread
+
+    void SyncBenchmark();       // cost of the synchronization primitives
     
 // These are public for notational convenience; really, 
 // they're global variables used everywhere.
@@ -67,8 +82,10 @@ class Kernel {
     PostOfficeInput *postOfficeIn;
     PostOfficeOutput *postOfficeOut;
     MemoryManager* memoryManager;
+    FutexTable* futexTable;     // waiters of user-level locks
 
     int hostName;               // machine identifier
+    int userStackSize;          // largest a user stack may grow, in bytes
 
   private:
     bool randomSlice;		// enable pseudo-random time slicing
@@ -76,6 +93,10 @@ class Kernel {
     double reliability;         // likelihood messages are dropped
     char *consoleIn;            // file to read console input from
     char *consoleOut;           // file to send console output to
+    char *traceFile;            // file to log page references to
+    char *quantumList;          // time slice of each priority level
+    char *shareList;            // CPU shares of users
+    SchedulingPolicy schedulingPolicy;	// which ReadyQueue to use
 #ifndef FILESYS_STUB
     bool formatFlag;          // format the disk if this is true
 #endif
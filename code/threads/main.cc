@@ -6,8 +6,10 @@
 //              -s -x <nachos file> -ci <consoleIn> -co <consoleOut>
 //              -f -cp <unix file> <nachos file>
 //              -p <nachos file> -r <nachos file> -l -D
-//              -n <network reliability> -m <machine id>
-//              -z -K -C -N
+//              -n <network reliability> -m <machine id> -rt <trace file>
+//              -q <quantum,quantum,...> -sp <policy> -sh <uid:shares,...>
+//              -ss <stack size>
+//              -z -K -C -N -T -F -E -U -J -I -S
 //
 //    -d causes certain debugging messages to be printed (see debug.h)
 //    -rs causes Yield to occur at random (but repeatable) spots
@@ -16,11 +18,28 @@
 //    -x runs a user program
 //    -ci specify file for console input (stdin is the default)
 //    -co specify file for console output (stdout is the default)
+//    -rt log every page reference to a file, for the pagesim tool
+//    -q preempt threads when their time slice runs out; gives the
+//       quantum in ticks of priority levels 0, 1, ... (see scheduler.h)
+//    -sp selects the scheduling policy: mlfq (the default), cfs,
+//       stride, lottery or share
+//    -sh gives the CPU shares of users under "-sp share"; users not
+//       listed get 100
+//    -ss sets in bytes how far a user program's stack may grow
+//       (UserStackSize by default, see addrspace.h)
 //    -n sets the network reliability
 //    -m sets this machine's host id (needed for the network)
 //    -K run a simple self test of kernel threads and synchronization
 //    -C run an interactive console test
 //    -N run a two-machine network test (see Kernel::NetworkTest)
+//    -T time address translation (see Kernel::TranslateBenchmark)
+//    -F compare CPU shares of competing threads (see Kernel::FairnessBenchmark)
+//    -E check deadlines of real-time threads (see Kernel::RealTimeBenchmark)
+//    -U compare CPU shares of users (see Kernel::FairShareBenchmark)
+//    -J time thread creation (see Kernel::ForkJoinBenchmark)
+//    -I measure priority inversion on a lock (see
+//       Kernel::PriorityInversionBenchmark)
+//    -S time the synchronization primitives (see Kernel::SyncBenchmark)
 //
 //    Filesystem-related flags:
 //    -f forces the Nachos disk to be formatted
@@ -181,6 +200,13 @@ int main(int argc, char **argv)
     bool threadTestFlag = false;
     bool consoleTestFlag = false;
     bool networkTestFlag = false;
+    bool translateBenchmarkFlag = false;
+    bool fairnessBenchmarkFlag = false;
+    bool realTimeBenchmarkFlag = false;
+    bool fairShareBenchmarkFlag = false;
+    bool forkJoinBenchmarkFlag = false;
+    bool priorityInversionBenchmarkFlag = false;
+    bool syncBenchmarkFlag = false;
 #ifndef FILESYS_STUB
     char *copyUnixFileName = NULL;   // UNIX file to be copied into Nachos
     char *copyNachosFileName = NULL; // name of copied file in Nachos
@@ -223,6 +249,34 @@ int main(int argc, char **argv)
         {
             networkTestFlag = TRUE;
         }
+        else if (strcmp(argv[i], "-T") == 0)
+        {
+            translateBenchmarkFlag = TRUE;
+        }
+        else if (strcmp(argv[i], "-F") == 0)
+        {
+            fairnessBenchmarkFlag = TRUE;
+        }
+        else if (strcmp(argv[i], "-E") == 0)
+        {
+            realTimeBenchmarkFlag = TRUE;
+        }
+        else if (strcmp(argv[i], "-U") == 0)
+        {
+            fairShareBenchmarkFlag = TRUE;
+        }
+        else if (strcmp(argv[i], "-J") == 0)
+        {
+            forkJoinBenchmarkFlag = TRUE;
+        }
+        else if (strcmp(argv[i], "-I") == 0)
+        {
+            priorityInversionBenchmarkFlag = TRUE;
+        }
+        else if (strcmp(argv[i], "-S") == 0)
+        {
+            syncBenchmarkFlag = TRUE;
+        }
 #ifndef FILESYS_STUB
         else if (strcmp(argv[i], "-cp") == 0)
         {
@@ -256,7 +310,7 @@ int main(int argc, char **argv)
         {
             cout << "Partial usage: nachos [-z -d debugFlags]\n";
             cout << "Partial usage: nachos [-x programName]\n";
-            cout << "Partial usage: nachos [-K] [-C] [-N]\n";
+            cout << "Partial usage: nachos [-K] [-C] [-N] [-T] [-F] [-E] [-U] [-J] [-I] [-S]\n";
 #ifndef FILESYS_STUB
             cout << "Partial usage: nachos [-cp UnixFile NachosFile]\n";
             cout << "Partial usage: nachos [-p fileName] [-r fileName]\n";
@@ -294,6 +348,34 @@ int main(int argc, char **argv)
     {
         kernel->NetworkTest(); // two-machine test of the network
     }
+    if (translateBenchmarkFlag)
+    {
+        kernel->TranslateBenchmark(); // time address translation
+    }
+    if (fairnessBenchmarkFlag)
+    {
+        kernel->FairnessBenchmark(); // CPU shares under the scheduling policy
+    }
+    if (realTimeBenchmarkFlag)
+    {
+        kernel->RealTimeBenchmark(); // EDF deadlines under load
+    }
+    if (fairShareBenchmarkFlag)
+    {
+        kernel->FairShareBenchmark(); // CPU shares of users
+    }
+    if (forkJoinBenchmarkFlag)
+    {
+        kernel->ForkJoinBenchmark(); // thread creation cost
+    }
+    if (priorityInversionBenchmarkFlag)
+    {
+        kernel->PriorityInversionBenchmark(); // lock wait under inversion
+    }
+    if (syncBenchmarkFlag)
+    {
+        kernel->SyncBenchmark(); // cost of semaphores, locks, conditions
+    }
 
 #ifndef FILESYS_STUB
     if (removeFileName != NULL)
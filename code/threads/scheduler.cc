@@ -11,8 +11,8 @@
 //	end up calling FindNextToRun(), and that would put us in an
 //	infinite loop.
 //
-// 	Very simple implementation -- no priorities, straight FIFO.
-//	Might need to be improved in later assignments.
+// 	The order in which ready threads run is up to the ReadyQueue
+//	chosen at startup (see scheduler.h).
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation
@@ -22,22 +22,35 @@
 #include "debug.h"
 #include "scheduler.h"
 #include "main.h"
+#include "MultiLevelQueue.h"
+#include "FairQueue.h"
+#include "StrideQueue.h"
+#include "LotteryQueue.h"
+#include "FairShareQueue.h"
+
+//----------------------------------------------------------------------
+// DeadlineCompare
+//	Order real-time threads by deadline; equal deadlines stay FIFO.
+//----------------------------------------------------------------------
 
 static int
-ThreadPriorityCompare(Thread *x, Thread *y)
+DeadlineCompare(Thread *x, Thread *y)
 {
-    if (x->getPriority() < y->getPriority())
-    {
-        return -1;
-    }
-    else if (x->getPriority() > y->getPriority())
-    {
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    if (x->rtDeadline < y->rtDeadline) { return -1; }
+    else if (x->rtDeadline > y->rtDeadline) { return 1; }
+    else { return 0; }
+}
+
+//----------------------------------------------------------------------
+// Utilization
+//	Share of the CPU a reservation of "budget" ticks every "period"
+//	takes, in millionths, rounded up.
+//----------------------------------------------------------------------
+
+static int
+Utilization(int budget, int period)
+{
+    return period == 0 ? 0 : (int)(((long long)budget * 1000000 + period - 1) / period);
 }
 
 //----------------------------------------------------------------------
@@ -46,10 +59,29 @@ ThreadPriorityCompare(Thread *x, Thread *y)
 //	Initially, no ready threads.
 //----------------------------------------------------------------------
 
-Scheduler::Scheduler()
+Scheduler::Scheduler(SchedulingPolicy policy, char *quantumList, char *shareList)
 {
-    readyList = new SortedList<Thread *>(ThreadPriorityCompare);
+    switch (policy) {
+      case SchedCFS:
+        readyList = new FairQueue();
+        break;
+      case SchedStride:
+        readyList = new StrideQueue();
+        break;
+      case SchedLottery:
+        readyList = new LotteryQueue();
+        break;
+      case SchedShare:
+        readyList = new FairShareQueue(shareList);
+        break;
+      default:
+        readyList = new MultiLevelQueue(quantumList);
+        break;
+    }
+    realTimeList = new SortedList<Thread *>(DeadlineCompare);
     toBeDestroyed = NULL;
+    lastDispatchTick = 0;
+    rtUtilization = 0;
 }
 
 //----------------------------------------------------------------------
@@ -60,6 +92,7 @@ Scheduler::Scheduler()
 Scheduler::~Scheduler()
 {
     delete readyList;
+    delete realTimeList;
 }
 
 //----------------------------------------------------------------------
@@ -75,8 +108,15 @@ void Scheduler::ReadyToRun(Thread *thread)
     ASSERT(kernel->interrupt->getLevel() == IntOff);
     DEBUG(dbgThread, "Putting thread on ready list: " << thread->getName());
 
+    if (thread == kernel->currentThread) {
+        Charge(thread);		// yielding: it used its time so far
+    }
     thread->setStatus(READY);
-    readyList->Insert(thread);
+    if (thread->rtPeriod > 0) {
+        realTimeList->Insert(thread);
+    } else {
+        readyList->Append(thread);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -92,12 +132,10 @@ Scheduler::FindNextToRun()
 {
     ASSERT(kernel->interrupt->getLevel() == IntOff);
 
-    if (readyList->IsEmpty()) {
-	    return NULL;
-    } 
-    else {
-        return readyList->RemoveFront();
+    if (!realTimeList->IsEmpty()) {
+        return realTimeList->RemoveFront();
     }
+    return readyList->RemoveFront();
 }
 
 //----------------------------------------------------------------------
@@ -137,9 +175,15 @@ void Scheduler::Run(Thread *nextThread, bool finishing)
 #endif
     oldThread->CheckOverflow(); // check if the old thread
                                 // had an undetected stack overflow
+    Charge(oldThread);		// no-op if it was charged when it yielded
 
     kernel->currentThread = nextThread; // switch to the next thread
     nextThread->setStatus(RUNNING);     // nextThread is now running
+    lastDispatchTick = kernel->stats->totalTicks;
+    if (nextThread->rtPeriod == 0 && nextThread->quantumLeft <= 0) {
+        nextThread->quantumLeft = readyList->getQuantum(nextThread);
+    }
+    kernel->stats->numContextSwitches++;
 
     DEBUG(dbgThread, "Switching from: " << oldThread->getName() << " to: " << nextThread->getName());
 
@@ -181,6 +225,7 @@ void Scheduler::CheckToBeDestroyed()
 {
     if (toBeDestroyed != NULL)
     {
+        rtUtilization -= Utilization(toBeDestroyed->rtBudget, toBeDestroyed->rtPeriod);
         kernel->threadManager->deleteThread(toBeDestroyed);
         toBeDestroyed = NULL;
     }
@@ -194,5 +239,181 @@ void Scheduler::CheckToBeDestroyed()
 void Scheduler::Print()
 {
     cout << "Ready list contents:\n";
+    realTimeList->Apply(ThreadPrint);
     readyList->Apply(ThreadPrint);
 }
+
+//----------------------------------------------------------------------
+// Scheduler::Charge
+// 	Account the CPU time used since it was last charged to "thread",
+//	the running thread.  A real-time thread that has used up its
+//	budget gets it refilled, and its deadline moves a period later.
+//----------------------------------------------------------------------
+
+void Scheduler::Charge(Thread *thread)
+{
+    int ticks = kernel->stats->totalTicks - lastDispatchTick;
+
+    lastDispatchTick = kernel->stats->totalTicks;
+    thread->cpuTicks += ticks;
+    thread->quantumLeft -= ticks;
+    if (thread->rtPeriod == 0) {
+        readyList->Charge(thread, ticks);
+        return;
+    }
+
+    thread->rtBudgetLeft -= ticks;
+    while (thread->rtBudgetLeft <= 0) {
+        thread->rtBudgetLeft += thread->rtBudget;
+        thread->rtDeadline += thread->rtPeriod;
+        kernel->stats->numBudgetOverruns++;
+        DEBUG(dbgThread, "Budget of " << thread->getName() << " overrun, deadline now " << thread->rtDeadline);
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::QuantumExpired
+// 	Charge the running thread for the time since it was last
+//	charged.  If a real-time thread with an earlier deadline is
+//	ready, or the running thread used up its quantum and the ready
+//	queue has a thread that should take over (see
+//	ReadyQueue::ShouldPreempt), return TRUE, so that the timer
+//	handler makes it yield.  Real-time threads have no quantum.
+//----------------------------------------------------------------------
+
+bool Scheduler::QuantumExpired()
+{
+    Thread *thread = kernel->currentThread;
+    int quantum;
+
+    Charge(thread);
+    if (EarlierDeadlineReady()) {
+        kernel->stats->numPreemptions++;
+        DEBUG(dbgThread, "Deadline of " << realTimeList->Front()->getName() << " preempts " << thread->getName());
+        return TRUE;
+    }
+    quantum = readyList->getQuantum(thread);
+    if (thread->rtPeriod > 0 || quantum == 0 || thread->quantumLeft > 0) {
+        return FALSE;		// no time slicing, or time left
+    }
+
+    thread->quantumLeft = quantum;
+    if (!readyList->ShouldPreempt(thread)) {
+        return FALSE;		// nobody at least as urgent to give the CPU to
+    }
+    kernel->stats->numPreemptions++;
+    DEBUG(dbgThread, "Quantum of " << thread->getName() << " expired");
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::EarlierDeadlineReady
+// 	Return TRUE if a ready real-time thread should preempt the
+//	running thread: the running thread is best-effort, or its
+//	deadline is later.
+//----------------------------------------------------------------------
+
+bool Scheduler::EarlierDeadlineReady()
+{
+    Thread *thread = kernel->currentThread;
+
+    if (realTimeList->IsEmpty()) {
+        return FALSE;
+    }
+    return thread->rtPeriod == 0 || realTimeList->Front()->rtDeadline < thread->rtDeadline;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::SetRealTime
+// 	Make "thread" a real-time thread that needs "budget" ticks of
+//	CPU every "period" ticks, or a best-effort thread again if
+//	"period" is 0.  Its first job starts now.  Admission control:
+//	refuse the reservation, returning FALSE, if the budget does not
+//	fit in the period or if the utilization of all real-time threads
+//	would exceed EdfMaxUtilization percent.  EDF meets every deadline
+//	of a set of threads whose utilization is at most 100%; the rest
+//	is left for interrupt handling and for best-effort threads.
+//
+//	"thread" must be running or not yet forked, so that it is not
+//	on a ready list.
+//----------------------------------------------------------------------
+
+bool Scheduler::SetRealTime(Thread *thread, int period, int budget)
+{
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    int utilization = Utilization(budget, period);
+    int others = rtUtilization - Utilization(thread->rtBudget, thread->rtPeriod);
+
+    ASSERT(thread->getStatus() != READY);
+    if (period < 0 || (period > 0 && (budget <= 0 || budget > period))
+        || others + utilization > EdfMaxUtilization * 10000)
+    {
+        DEBUG(dbgThread, "Refusing reservation of " << budget << "/" << period << " for " << thread->getName());
+        kernel->interrupt->SetLevel(oldLevel);
+        return FALSE;
+    }
+
+    if (thread == kernel->currentThread) {
+        Charge(thread);		// the time so far was on the old terms
+    }
+    rtUtilization = others + utilization;
+    thread->rtPeriod = period;
+    thread->rtBudget = thread->rtBudgetLeft = budget;
+    thread->rtDeadline = thread->rtJobDeadline = kernel->stats->totalTicks + period;
+    kernel->interrupt->SetLevel(oldLevel);
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::WaitNextPeriod
+// 	Called by a real-time thread when it has finished the job of
+//	its current period.  Count a deadline miss if it is late, then
+//	sleep until the next period starts, with a fresh budget.  A late
+//	job's successor starts right away, with its period counted from
+//	now.
+//----------------------------------------------------------------------
+
+void Scheduler::WaitNextPeriod()
+{
+    Thread *thread = kernel->currentThread;
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    int now = kernel->stats->totalTicks;
+    int release = max(thread->rtJobDeadline, now);
+
+    ASSERT(thread->rtPeriod > 0);
+    kernel->stats->numRealTimeJobs++;
+    if (now > thread->rtJobDeadline) {
+        kernel->stats->numDeadlineMisses++;
+        DEBUG(dbgThread, thread->getName() << " missed its deadline by " << now - thread->rtJobDeadline << " ticks");
+    }
+
+    Charge(thread);
+    thread->rtBudgetLeft = thread->rtBudget;
+    thread->rtDeadline = thread->rtJobDeadline = release + thread->rtPeriod;
+    kernel->alarm->WaitUntil(release - now);
+    kernel->interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// Scheduler::ChangePriority
+// 	Set the priority "thread" is scheduled at, as returned by
+//	Thread::getPriority, without touching its own priority.  Locks
+//	use this to lend the priority of a waiting thread to the lock
+//	holder and to take it back.  If the holder is on the ready list,
+//	the ready list re-sorts it, so that it no longer waits behind
+//	threads less urgent than the one it is blocking.
+//----------------------------------------------------------------------
+
+void Scheduler::ChangePriority(Thread *thread, int priority)
+{
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+
+    if (thread->activePriority == priority) {
+        return;
+    }
+    DEBUG(dbgThread, "Priority of " << thread->getName() << " now " << priority);
+    thread->activePriority = priority;
+    if (thread->getStatus() == READY && thread->rtPeriod == 0) {
+        readyList->Reprioritize(thread);
+    }
+}
@@ -19,14 +19,55 @@
 #include "copyright.h"
 #include "list.h"
 #include "thread.h"
+#include "ReadyQueue.h"
 
 // The following class defines the scheduler/dispatcher abstraction -- 
 // the data structures and operations needed to keep track of which 
 // thread is running, and which threads are ready but not running.
+//
+// Which ready thread runs next is up to the ReadyQueue, chosen at
+// startup with "-sp":
+//	mlfq -- multilevel feedback queue by priority (MultiLevelQueue.h)
+//	cfs  -- CPU shared in proportion to weights (FairQueue.h)
+//	stride  -- CPU shared in proportion to tickets, deterministically
+//		   (StrideQueue.h)
+//	lottery -- CPU shared in proportion to tickets, by a random draw
+//		   for each quantum (LotteryQueue.h)
+//	share   -- CPU shared among users (uids) by configured shares,
+//		   then equally among each user's threads (FairShareQueue.h)
+//
+// Real-time threads are scheduled ahead of all of these, earliest
+// deadline first (EDF).  A thread joins the real-time class with
+// SetRealTime, declaring a period and a budget of CPU ticks per
+// period; the reservation is refused if it would take the total
+// utilization of real-time threads past EdfMaxUtilization percent.
+// Each period the thread runs one job and ends it with WaitNextPeriod,
+// which sleeps until the next period starts.  A job that finishes
+// after the end of its period is a deadline miss.  A job that
+// overruns its budget has its deadline postponed by a period, with
+// the budget refilled (as in a constant bandwidth server), so it
+// cannot take CPU time reserved by the other real-time threads.
+//
+// The Scheduler charges the running thread for the CPU time it uses,
+// at each timer interrupt and when it gives up the CPU.  A thread is
+// preempted only once its quantum, as set by the ReadyQueue, has run
+// out; a thread that blocks keeps what is left of its quantum for
+// the next time it runs.
+
+enum SchedulingPolicy { SchedMLFQ, SchedCFS, SchedStride, SchedLottery, SchedShare };
+
+#define EdfMaxUtilization 90		// percent; the rest is slack for
+					// interrupt handling and best-effort
+					// threads
 
 class Scheduler {
   public:
-    Scheduler();		// Initialize list of ready threads 
+    Scheduler(SchedulingPolicy policy, char *quantumList, char *shareList);
+				// Initialize list of ready threads;
+				// "quantumList" gives the MLFQ quanta
+				// ("-q"), NULL for no time slicing;
+				// "shareList" the shares of users
+				// ("-sh"), NULL for equal shares
     ~Scheduler();		// De-allocate ready list
 
     void ReadyToRun(Thread* thread);	
@@ -38,14 +79,43 @@ class Scheduler {
     void CheckToBeDestroyed();// Check if thread that had been
     				// running needs to be deleted
     void Print();		// Print contents of ready list
+    void PrintStatistics() { readyList->PrintStatistics(); }
+				// Print what the policy accounted
+
+    bool QuantumExpired();	// Called on each timer interrupt; TRUE
+				// if the running thread should yield
+    bool EarlierDeadlineReady();	// TRUE if a ready real-time thread
+				// should take the CPU from the running one
+
+    bool SetRealTime(Thread *thread, int period, int budget);
+				// Reserve "budget" ticks of every "period"
+				// for "thread", which must not be ready;
+				// FALSE if the reservation is refused.
+				// A period of 0 makes it best-effort again
+    void WaitNextPeriod();	// End the running real-time thread's
+				// job; sleep until its next period
+    void ChangePriority(Thread *thread, int priority);
+				// Schedule "thread" at "priority" from now
+				// on; a ready thread moves in the ready
+				// list.  Used for priority inheritance
+    int getWeight(Thread *thread) { return readyList->getWeight(thread); }
+				// Share of the CPU the policy aims to
+				// give "thread"
     
     // SelfTest for scheduler is implemented in class Thread
     
   private:
-    SortedList<Thread *> *readyList;  // queue of threads that are ready to run,
-				// but not running  按照线程优先级进行排序
+    ReadyQueue *readyList;	// queue of threads that are ready to run,
+				// but not running
+    SortedList<Thread *> *realTimeList;	// ready real-time threads,
+				// earliest deadline first
     Thread *toBeDestroyed;	// finishing thread to be destroyed
     				// by the next thread that runs
+    int lastDispatchTick;	// When the running thread was last charged
+    int rtUtilization;		// Reserved by real-time threads, in
+				// millionths of the CPU
+
+    void Charge(Thread *thread);	// Account CPU time to the running thread
 };
 
 #endif // SCHEDULER_H
@@ -1,7 +1,7 @@
 // synch.cc 
-//	Routines for synchronizing threads.  Three kinds of
-//	synchronization routines are defined here: semaphores, locks 
-//   	and condition variables.
+//	Routines for synchronizing threads.  Five kinds of
+//	synchronization routines are defined here: semaphores, locks,
+//   	condition variables, reader-writer locks and barriers.
 //
 // Any implementation of a synchronization routine needs some
 // primitive atomic operation.  We assume Nachos is running on
@@ -18,16 +18,20 @@
 //
 // Once we'e implemented one set of higher level atomic operations,
 // we can implement others using that implementation.  We illustrate
-// this by implementing locks and condition variables on top of 
-// semaphores, instead of directly enabling and disabling interrupts.
+// this by implementing condition variables on top of semaphores,
+// instead of directly enabling and disabling interrupts.
 //
-// Locks are implemented using a semaphore to keep track of
-// whether the lock is held or not -- a semaphore value of 0 means
-// the lock is busy; a semaphore value of 1 means the lock is free.
+// Locks disable interrupts directly rather than using a semaphore,
+// because they keep their own list of waiters: they lend the
+// priority of the waiters to the holder (see synch.h) and wake the
+// most urgent waiter first.
 //
 // The implementation of condition variables using semaphores is
 // a bit trickier, as explained below under Condition::Wait.
 //
+// Reader-writer locks and barriers are monitors: a lock and
+// condition variables around a few counters.
+//
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
 // of liability and disclaimer of warranty provisions.
@@ -158,8 +162,9 @@ Semaphore::SelfTest()
 Lock::Lock(char* debugName)
 {
     name = debugName;
-    semaphore = new Semaphore("lock", 1);  // initially, unlocked
     lockHolder = NULL;
+    waiters = new List<Thread *>;
+    nextHeld = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -168,28 +173,45 @@ Lock::Lock(char* debugName)
 //----------------------------------------------------------------------
 Lock::~Lock()
 {
-    delete semaphore;
+    delete waiters;
 }
 
 //----------------------------------------------------------------------
 // Lock::Acquire
 //	Atomically wait until the lock is free, then set it to busy.
-//	Equivalent to Semaphore::P(), with the semaphore value of 0
-//	equal to busy, and semaphore value of 1 equal to free.
+//	While waiting, lend our priority to the holder.  As with
+//	Semaphore::P(), the lock may have been taken by somebody else
+//	again by the time we run, so check once more when woken up.
 //----------------------------------------------------------------------
 
 void Lock::Acquire()
 {
-    semaphore->P();
-    lockHolder = kernel->currentThread;
+    Interrupt *interrupt = kernel->interrupt;
+    Thread *currentThread = kernel->currentThread;
+    IntStatus oldLevel = interrupt->SetLevel(IntOff);
+
+    ASSERT(!IsHeldByCurrentThread());
+    while (lockHolder != NULL) {
+	waiters->Append(currentThread);
+	currentThread->waitingLock = this;
+	Donate(currentThread->getPriority());
+	currentThread->Sleep(FALSE);
+    }
+    currentThread->waitingLock = NULL;
+    lockHolder = currentThread;
+    nextHeld = currentThread->heldLocks;
+    currentThread->heldLocks = this;
+
+    (void) interrupt->SetLevel(oldLevel);
 }
 
 //----------------------------------------------------------------------
 // Lock::Release
-//	Atomically set lock to be free, waking up a thread waiting
-//	for the lock, if any.
-//	Equivalent to Semaphore::V(), with the semaphore value of 0
-//	equal to busy, and semaphore value of 1 equal to free.
+//	Atomically set lock to be free, waking up the highest-priority
+//	thread waiting for the lock (the longest waiting among equals),
+//	if any.  Give back the priority lent through this lock; what is
+//	lent through other locks we still hold is kept.  If that lowers
+//	our priority, a more urgent thread was waiting, so let it run.
 //
 //	By convention, only the thread that acquired the lock
 // 	may release it.
@@ -197,9 +219,70 @@ void Lock::Acquire()
 
 void Lock::Release()
 {
+    Interrupt *interrupt = kernel->interrupt;
+    Thread *currentThread = kernel->currentThread;
+    IntStatus oldLevel = interrupt->SetLevel(IntOff);
+    int oldPriority = currentThread->getPriority();
+    int priority = currentThread->getBasePriority();
+    Thread *next = NULL;
+    Lock **link;
+
     ASSERT(IsHeldByCurrentThread());
+    for (link = &currentThread->heldLocks; *link != this; link = &(*link)->nextHeld)
+	;
+    *link = nextHeld;
     lockHolder = NULL;
-    semaphore->V();
+
+    for (ListIterator<Thread *> iter(waiters); !iter.IsDone(); iter.Next()) {
+	if (next == NULL || iter.Item()->getPriority() < next->getPriority())
+	    next = iter.Item();
+    }
+    if (next != NULL) {
+	waiters->Remove(next);
+	kernel->scheduler->ReadyToRun(next);
+    }
+
+    for (Lock *lock = currentThread->heldLocks; lock != NULL; lock = lock->nextHeld)
+	priority = lock->WaiterPriority(priority);
+    kernel->scheduler->ChangePriority(currentThread, priority);
+    if (priority > oldPriority)
+	currentThread->Yield();
+
+    (void) interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// Lock::Donate
+//	Raise the holder of this lock to "priority" (smaller numbers are
+//	more urgent).  If the holder is itself waiting for a lock, that
+//	lock's holder is holding us up too, so raise it as well, and so
+//	on down the chain.  The walk stops at the first thread that is
+//	already at least as urgent, which also ends it on a deadlock
+//	cycle.
+//----------------------------------------------------------------------
+
+void Lock::Donate(int priority)
+{
+    Lock *lock = this;
+
+    while (lock != NULL && lock->lockHolder != NULL
+	   && lock->lockHolder->getPriority() > priority) {
+	kernel->scheduler->ChangePriority(lock->lockHolder, priority);
+	lock = lock->lockHolder->waitingLock;
+    }
+}
+
+//----------------------------------------------------------------------
+// Lock::WaiterPriority
+//	Return the most urgent of "priority" and the priorities of
+//	the threads waiting for this lock.
+//----------------------------------------------------------------------
+
+int Lock::WaiterPriority(int priority)
+{
+    for (ListIterator<Thread *> iter(waiters); !iter.IsDone(); iter.Next())
+	priority = min(priority, iter.Item()->getPriority());
+    return priority;
 }
 
 //----------------------------------------------------------------------
@@ -295,3 +378,192 @@ void Condition::Broadcast(Lock* conditionLock)
         Signal(conditionLock);
     }
 }
+
+//----------------------------------------------------------------------
+// RWLock::RWLock
+// 	Initialize a reader-writer lock, initially free.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//	"fair" admits threads in order of arrival, rather than
+//	preferring writers.
+//----------------------------------------------------------------------
+
+RWLock::RWLock(char* debugName, bool fair)
+{
+    name = debugName;
+    this->fair = fair;
+    lock = new Lock("rwlock");
+    readOk = new Condition("rwlock read");
+    writeOk = new Condition("rwlock write");
+    turn = new Condition("rwlock turn");
+    readers = waitingWriters = 0;
+    writer = NULL;
+    nextTicket = nowServing = 0;
+}
+
+//----------------------------------------------------------------------
+// RWLock::~RWLock
+// 	Deallocate a reader-writer lock.
+//----------------------------------------------------------------------
+
+RWLock::~RWLock()
+{
+    delete lock;
+    delete readOk;
+    delete writeOk;
+    delete turn;
+}
+
+//----------------------------------------------------------------------
+// RWLock::AcquireRead
+//	Wait until we may read.  Preferring writers, that is once no
+//	writer holds the lock or waits for it.  In fair mode, once all
+//	threads that arrived before us are in and no writer holds the
+//	lock; we then let the thread after us try, so consecutive
+//	readers get in together.
+//----------------------------------------------------------------------
+
+void RWLock::AcquireRead()
+{
+    lock->Acquire();
+    if (fair) {
+        int ticket = nextTicket++;
+        while (ticket != nowServing || writer != NULL) {
+            turn->Wait(lock);
+        }
+        nowServing++;
+        turn->Broadcast(lock);
+    } else {
+        while (writer != NULL || waitingWriters > 0) {
+            readOk->Wait(lock);
+        }
+    }
+    readers++;
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::ReleaseRead
+//	The last reader out lets a writer in.
+//----------------------------------------------------------------------
+
+void RWLock::ReleaseRead()
+{
+    lock->Acquire();
+    ASSERT(readers > 0);
+    readers--;
+    if (readers == 0) {
+        if (fair) {
+            turn->Broadcast(lock);
+        } else {
+            writeOk->Signal(lock);
+        }
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::AcquireWrite
+//	Wait until nobody else holds the lock (and, in fair mode, all
+//	threads that arrived before us have had their turn).
+//----------------------------------------------------------------------
+
+void RWLock::AcquireWrite()
+{
+    lock->Acquire();
+    ASSERT(!IsWriteHeldByCurrentThread());
+    if (fair) {
+        int ticket = nextTicket++;
+        while (ticket != nowServing || writer != NULL || readers > 0) {
+            turn->Wait(lock);
+        }
+    } else {
+        waitingWriters++;
+        while (writer != NULL || readers > 0) {
+            writeOk->Wait(lock);
+        }
+        waitingWriters--;
+    }
+    writer = kernel->currentThread;
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::ReleaseWrite
+//	Preferring writers, hand the lock to the next writer if there
+//	is one, otherwise let all the waiting readers in.  In fair mode,
+//	let the next thread in line go.
+//----------------------------------------------------------------------
+
+void RWLock::ReleaseWrite()
+{
+    lock->Acquire();
+    ASSERT(IsWriteHeldByCurrentThread());
+    writer = NULL;
+    if (fair) {
+        nowServing++;
+        turn->Broadcast(lock);
+    } else if (waitingWriters > 0) {
+        writeOk->Signal(lock);
+    } else {
+        readOk->Broadcast(lock);
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// Barrier::Barrier
+// 	Initialize a barrier for "count" threads.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//----------------------------------------------------------------------
+
+Barrier::Barrier(char* debugName, int count)
+{
+    ASSERT(count > 0);
+    name = debugName;
+    this->count = count;
+    arrived = round = 0;
+    lock = new Lock("barrier");
+    allArrived = new Condition("barrier");
+}
+
+//----------------------------------------------------------------------
+// Barrier::~Barrier
+// 	Deallocate a barrier.  Assume no one is still waiting at it!
+//----------------------------------------------------------------------
+
+Barrier::~Barrier()
+{
+    delete lock;
+    delete allArrived;
+}
+
+//----------------------------------------------------------------------
+// Barrier::Wait
+//	Wait for the rest of this round's threads.  The last one to
+//	arrive starts the next round, wakes up the others and returns
+//	TRUE.  The others wait for the round number to change, not for
+//	"arrived" to reach "count": by the time they run, threads of
+//	the next round may already be arriving.
+//----------------------------------------------------------------------
+
+bool Barrier::Wait()
+{
+    lock->Acquire();
+    int myRound = round;
+
+    arrived++;
+    if (arrived == count) {
+        arrived = 0;
+        round++;
+        allArrived->Broadcast(lock);
+        lock->Release();
+        return TRUE;
+    }
+    while (round == myRound) {
+        allArrived->Wait(lock);
+    }
+    lock->Release();
+    return FALSE;
+}
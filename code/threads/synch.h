@@ -1,8 +1,8 @@
 // synch.h 
 //	Data structures for synchronizing threads.
 //
-//	Three kinds of synchronization are defined here: semaphores,
-//	locks, and condition variables.
+//	Five kinds of synchronization are defined here: semaphores,
+//	locks, condition variables, reader-writer locks and barriers.
 //
 //	Note that all the synchronization objects take a "name" as
 //	part of the initialization.  This is solely for debugging purposes.
@@ -62,6 +62,14 @@ class Semaphore {
 // In addition, by convention, only the thread that acquired the lock
 // may release it.  As with semaphores, you can't read the lock value
 // (because the value might change immediately after you read it).  
+//
+// Locks implement priority inheritance: a thread that has to wait in
+// Acquire lends its priority to the lock holder, and if the holder is
+// itself waiting for another lock, to that lock's holder in turn.  The
+// holder is scheduled at the borrowed priority until it releases the
+// lock, so a high-priority thread is not kept waiting behind threads
+// of medium priority that happen to be ahead of the holder.  Release
+// hands the lock to the highest-priority waiter.
 
 class Lock {
   public:
@@ -82,7 +90,14 @@ class Lock {
   private:
     char *name;			// debugging assist
     Thread *lockHolder;		// thread currently holding lock
-    Semaphore *semaphore;	// we use a semaphore to implement lock
+    List<Thread *> *waiters;	// threads waiting in Acquire
+    Lock *nextHeld;		// next lock held by lockHolder
+
+    void Donate(int priority);	// lend "priority" to the holder, and
+				// on along the chain of held locks
+    int WaiterPriority(int priority);
+				// the highest of "priority" and that
+				// of the waiters
 };
 
 // The following class defines a "condition variable".  A condition
@@ -140,4 +155,80 @@ class Condition {
     char* name;
     List<Semaphore *> *waitQueue;	// list of waiting threads
 };
+// The following class defines a "reader-writer lock", for data that
+// is read much more often than it is changed.  Any number of readers
+// may hold the lock at once, but a writer holds it alone:
+//
+//	AcquireRead -- wait until no writer holds the lock, then hold it
+//		for reading
+//
+//	AcquireWrite -- wait until nobody holds the lock, then hold it
+//		for writing
+//
+//	ReleaseRead, ReleaseWrite -- give up the lock
+//
+// By default the lock prefers writers: once a writer waits, no new
+// readers get in, so a steady stream of readers cannot starve the
+// writers (but writers can starve readers).  A "fair" lock admits
+// readers and writers strictly in the order they arrived instead,
+// letting in all readers that arrive between two writers together.
+//
+// As with locks, only a thread holding the lock may release it.
+
+class RWLock {
+  public:
+    RWLock(char* debugName, bool fair = FALSE);
+				// initialize lock to be FREE
+    ~RWLock();			// deallocate lock
+    char* getName() { return name; }	// debugging assist
+
+    void AcquireRead();
+    void ReleaseRead();
+    void AcquireWrite();
+    void ReleaseWrite();
+    bool IsWriteHeldByCurrentThread() {
+		return writer == kernel->currentThread; }
+
+  private:
+    char* name;			// debugging assist
+    bool fair;			// FIFO order, rather than writers first
+    Lock *lock;			// protects the fields below
+    Condition *readOk;		// readers wait here (writers first)
+    Condition *writeOk;		// writers wait here (writers first)
+    Condition *turn;		// everybody waits here (fair)
+    int readers;		// threads holding the lock for reading
+    Thread *writer;		// thread holding the lock for writing
+    int waitingWriters;		// writers waiting in AcquireWrite
+    int nextTicket;		// fair: handed out in order of arrival
+    int nowServing;		// fair: the ticket that may go next
+};
+
+// The following class defines a "barrier", at which a fixed number
+// of threads wait for each other:
+//
+//	Wait -- wait until "count" threads (counting this one) have
+//		called Wait
+//
+// The barrier is then ready for the next round.  Exactly one thread
+// of each round gets TRUE back from Wait, for work that must be done
+// once per round.
+
+class Barrier {
+  public:
+    Barrier(char* debugName, int count);
+				// "count" threads meet at the barrier
+    ~Barrier();			// deallocate the barrier
+    char* getName() { return name; }	// debugging assist
+
+    bool Wait();		// TRUE in one thread per round
+
+  private:
+    char* name;			// debugging assist
+    int count;			// threads to wait for
+    int arrived;		// threads waiting in this round
+    int round;			// number of rounds completed
+    Lock *lock;			// protects the fields above
+    Condition *allArrived;	// threads wait here for the last one
+};
+
 #endif // SYNCH_H
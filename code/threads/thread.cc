@@ -35,34 +35,62 @@ int testnum = 2;
 //----------------------------------------------------------------------
 Thread::Thread(char* threadName)
 {
-    priority = 0;
-    name = threadName;
-    stackTop = NULL;
     stack = NULL;
-    status = JUST_CREATED;
-
-    parent = kernel->currentThread;
     activeChild = new List<Thread*>();
     exitedChild = new List<Thread*>();
-
-#ifdef USER_PROGRAM
-    space = NULL;
-#endif
+    Init(threadName);
 }
 
 Thread::Thread(char *threadName, int uid, int pid)
 {
     this->pid = pid;
     this->uid = uid;
-    priority = 0;
+    stack = NULL;
+    activeChild = new List<Thread*>();
+    exitedChild = new List<Thread*>();
+    Init(threadName);
+}
+
+//----------------------------------------------------------------------
+// Thread::Recycle
+// 	Turn the control block of a thread that has been destroyed (see
+//	ThreadManager::deleteThread) into a new thread, ready for
+//	Thread::Fork.  The stack and the lists of children are kept
+//	and reused, not reallocated.
+//----------------------------------------------------------------------
+
+void
+Thread::Recycle(char *threadName, int uid, int pid)
+{
+    ASSERT(activeChild->IsEmpty() && exitedChild->IsEmpty());
+
+    this->pid = pid;
+    this->uid = uid;
+    Init(threadName);
+}
+
+//----------------------------------------------------------------------
+// Thread::Init
+// 	Initialize everything but the stack, pid, uid and the lists of
+//	children, which a recycled thread already has.
+//----------------------------------------------------------------------
+
+void
+Thread::Init(char *threadName)
+{
+    priority = activePriority = 0;
+    tickets = DefaultTickets;
     name = threadName;
     stackTop = NULL;
-    stack = NULL;
     status = JUST_CREATED;
+    cpuTicks = level = levelTicks = boostEpoch = quantumLeft = vruntime = 0;
+    readyWeight = 0;
+    readySeq = 0;
+    rtPeriod = rtBudget = rtBudgetLeft = rtDeadline = rtJobDeadline = 0;
+    nextReady = childReady = NULL;
+    waitingLock = heldLocks = NULL;
 
     parent = kernel->currentThread;
-    activeChild = new List<Thread*>();
-    exitedChild = new List<Thread*>();
 
 #ifdef USER_PROGRAM
     space = NULL;
@@ -342,7 +370,9 @@ PLabelToAddr(void *plabel)
 
 void Thread::StackAllocate(VoidFunctionPtr func, void *arg)
 {
-    stack = (int *)AllocBoundedArray(StackSize * sizeof(int));
+    if (stack == NULL) {	// a recycled thread keeps its stack
+        stack = (int *)AllocBoundedArray(StackSize * sizeof(int));
+    }
 
 #ifdef PARISC
     // HP stack works from low addresses to high addresses
@@ -413,6 +443,8 @@ void Thread::SaveUserState()
 {
     for (int i = 0; i < NumTotalRegs; i++)
         userRegisters[i] = kernel->machine->ReadRegister(i);
+    kernel->machine->BreakLink();	// our LL must not pair with
+					// another thread's SC
 }
 
 //----------------------------------------------------------------------
@@ -429,6 +461,19 @@ void Thread::RestoreUserState()
     for (int i = 0; i < NumTotalRegs; i++)
         kernel->machine->WriteRegister(i, userRegisters[i]);
 }
+
+//----------------------------------------------------------------------
+// Thread::SetUserRegister
+//	Change one register of the saved user-level CPU state; used to
+//	set up a thread that has not run yet (e.g., the return value of
+//	Fork in the child process).
+//----------------------------------------------------------------------
+
+void Thread::SetUserRegister(int id, int value)
+{
+    ASSERT(id >= 0 && id < NumTotalRegs);
+    userRegisters[id] = value;
+}
 #endif
 
 void
@@ -458,6 +503,38 @@ Thread::removeExitedChild(int threadId)
     return child;
 }
 
+/**
+ * @description: 线程被销毁或者回收之前调用：子线程成为孤儿，自己从父线程的子线程链表中删除，
+ *               这样回收之后的TCB不会再被当成原来的线程，父子线程先后销毁也不会留下悬空的指针
+ * @param none
+ * @return:
+ */
+void
+Thread::detachFamily()
+{
+    while (!activeChild->IsEmpty())
+    {
+        activeChild->RemoveFront()->setParent(NULL);
+    }
+    while (!exitedChild->IsEmpty())
+    {
+        exitedChild->RemoveFront()->setParent(NULL);
+    }
+
+    if (parent != NULL)
+    {
+        if (parent->activeChild->IsInList(this))
+        {
+            parent->activeChild->Remove(this);
+        }
+        if (parent->exitedChild->IsInList(this))
+        {
+            parent->exitedChild->Remove(this);
+        }
+        parent = NULL;
+    }
+}
+
 //----------------------------------------------------------------------
 // SimpleThread
 // 	Loop 5 times, yielding the CPU to another ready thread
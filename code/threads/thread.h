@@ -58,6 +58,13 @@
 // WATCH OUT IF THIS ISN'T BIG ENOUGH!!!!!
 const int StackSize = (8 * 1024);	// in words
 
+// Tickets of a thread under stride and lottery scheduling; its share
+// of the CPU is its tickets over those of all runnable threads.
+const int DefaultTickets = 100;
+const int MaxTickets = 10000;
+
+
+class Lock;
 
 // Thread state
 enum ThreadStatus { JUST_CREATED, RUNNING, READY, BLOCKED, ZOMMBIE };
@@ -88,6 +95,9 @@ class Thread {
 					// NOTE -- thread being deleted
 					// must not be running when delete 
 					// is called
+    void Recycle(char* threadName, int uid, int pid);
+					// Reinitialize a finished thread
+					// for reuse, keeping its stack
 
     // basic thread operations
 
@@ -109,14 +119,21 @@ class Thread {
     int getUid() {return uid;}
     int getPid() {return pid;}
     
-    void setPriority(int priority) { this->priority = priority; }
-    int getPriority() { return priority; }
+    void setPriority(int priority) { this->priority = level = activePriority = priority; }
+    int getPriority() { return activePriority; }
+				// Priority the thread is scheduled at:
+				// its own, or a higher one donated by a
+				// thread waiting for a lock it holds
+    int getBasePriority() { return priority; }
+    void setTickets(int tickets) { this->tickets = tickets; }
+    int getTickets() { return tickets; }
 
     Thread* getParent() {return parent;}
     void setParent(Thread* parent) {this->parent = parent;}
     void addChild(Thread* child);
     void childThreadExit(Thread* child);
     Thread* removeExitedChild(int threadId);
+    void detachFamily();
 
   private:
     // some of the private data for this class is listed above
@@ -129,13 +146,17 @@ class Thread {
     int uid;
     int pid;
     int priority; //数字越小代表优先级越高,默认为0
+    int tickets;  //步幅调度和彩票调度中CPU份额的权重
 
     Thread* parent;
     List<Thread*>* activeChild;
     List<Thread*>* exitedChild;
 
+    void Init(char* threadName);	// Set up the state common to new
+				// and recycled threads
     void StackAllocate(VoidFunctionPtr func, void *arg);
-    				// Allocate a stack for thread.
+    				// Allocate a stack for thread, unless
+				// it kept one from a previous life.
 				// Used internally by Fork()
 
 // A thread running a user program actually has *two* sets of CPU registers -- 
@@ -150,6 +171,38 @@ class Thread {
     void SetUserRegister(int id, int value);
 
     AddrSpace* space;
+
+// Scheduling state, maintained by the Scheduler and its ReadyQueue.
+
+    int cpuTicks;		// Total CPU time used
+    int level;			// Multilevel feedback queue level; starts
+				// at the priority and drops as the thread
+				// uses up its CPU allotment at each level
+    int levelTicks;		// CPU time used at the current level
+    int boostEpoch;		// Last priority boost applied to the thread
+    int quantumLeft;		// Ticks left in the current time slice
+    int rtPeriod;		// Real-time period in ticks; 0 for a
+				// best-effort thread
+    int rtBudget;		// CPU ticks reserved in each period
+    int rtBudgetLeft;		// Of the budget, before the deadline is
+				// postponed
+    int rtDeadline;		// Deadline the EDF queue is sorted by
+    int rtJobDeadline;		// End of the period of the current job
+    long long vruntime;		// Weighted CPU time: the key of the fair
+				// and stride queues (the pass in stride)
+    int readyWeight;		// Weight the fair queue counted the thread
+				// with when it was queued
+    unsigned int readySeq;	// Insertion order in a ThreadHeap, which
+				// breaks ties between equal keys
+    Thread *nextReady;		// Link in the ready queue
+    Thread *childReady;		// First child, if the ready queue is a heap
+
+// Priority inheritance state, maintained by Lock.
+
+    int activePriority;		// Returned by getPriority
+    Lock *waitingLock;		// Lock the thread waits for in Acquire
+    Lock *heldLocks;		// Locks the thread holds, linked
+				// through Lock::nextHeld
 };
 
 // external function, dummy routine whose sole job is to call Thread::Print
@@ -0,0 +1,150 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-29 15:10:27
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-29 17:36:45
+ * @Description:
+ */
+#include "FutexTable.h"
+#include "main.h"
+#include "addrspace.h"
+
+FutexTable::FutexTable()
+{
+    for (int i = 0; i < FutexBuckets; i++)
+    {
+        head[i] = tail[i] = NULL;
+    }
+    waiterNums = 0;
+}
+
+/**
+ * @description: 在值和期望值比较之后、睡眠之前关中断，FutexWake不会在这中间发生，唤醒不会丢失。
+ *               读值可能缺页，处理缺页时可能切换线程，ReadMem会重试到页在内存中，比较用的是最后读到的值
+ * @param {int addr, int expected}
+ * @return: 被唤醒时返回0，值不等或地址非法时返回-1
+ */
+int
+FutexTable::wait(int addr, int expected)
+{
+    FutexWaiter waiter;
+    int value;
+
+    if (!getKey(addr, &waiter.object, &waiter.offset))
+    {
+        return -1;
+    }
+
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    if (!kernel->machine->ReadMem(addr, 4, &value) || value != expected)
+    {
+        kernel->interrupt->SetLevel(oldLevel);
+        return -1;
+    }
+
+    int bucket = hash(waiter.object, waiter.offset);
+    waiter.thread = kernel->currentThread;
+    waiter.next = NULL;
+    if (tail[bucket] == NULL)
+    {
+        head[bucket] = &waiter;
+    }
+    else
+    {
+        tail[bucket]->next = &waiter;
+    }
+    tail[bucket] = &waiter;
+    waiterNums++;
+
+    DEBUG(dbgSys, "Futex wait at " << addr << " by " << waiter.thread->getName());
+    kernel->currentThread->Sleep(FALSE);
+    kernel->interrupt->SetLevel(oldLevel);
+    return 0;
+}
+
+int
+FutexTable::wake(int addr, int count)
+{
+    void* object;
+    int offset, woken = 0;
+
+    if (!getKey(addr, &object, &offset))
+    {
+        return 0;
+    }
+
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    int bucket = hash(object, offset);
+    FutexWaiter* prev = NULL;
+    FutexWaiter* waiter = head[bucket];
+
+    while (waiter != NULL && woken < count)
+    {
+        FutexWaiter* next = waiter->next;
+        if (waiter->object != object || waiter->offset != offset)
+        {
+            prev = waiter;
+            waiter = next;
+            continue;
+        }
+
+        if (prev == NULL)
+        {
+            head[bucket] = next;
+        }
+        else
+        {
+            prev->next = next;
+        }
+        if (tail[bucket] == waiter)
+        {
+            tail[bucket] = prev;
+        }
+        waiterNums--;
+        woken++;
+        //waiter在被唤醒线程的栈上，摘下之后不能再访问
+        kernel->scheduler->ReadyToRun(waiter->thread);
+        waiter = next;
+    }
+    kernel->interrupt->SetLevel(oldLevel);
+
+    DEBUG(dbgSys, "Futex wake at " << addr << " woke " << woken);
+    return woken;
+}
+
+/**
+ * @description: 共享内存段中的地址用(段, 段内偏移)标识，其它地址用(地址空间, 虚拟地址)
+ * @param {int addr}
+ * @return: 地址没有按字对齐时返回FALSE
+ */
+bool
+FutexTable::getKey(int addr, void** object, int* offset)
+{
+    AddrSpace* space = kernel->currentThread->space;
+
+    if ((addr & 0x3) != 0 || space == NULL)
+    {
+        return FALSE;
+    }
+
+    MappedRegion* region = space->findMappedRegion((unsigned) addr / PageSize);
+    if (region != NULL && region->getSegment() != NULL)
+    {
+        *object = region->getSegment();
+        *offset = addr - region->getStartPage() * PageSize;
+    }
+    else
+    {
+        *object = space;
+        *offset = addr;
+    }
+    return TRUE;
+}
+
+int
+FutexTable::hash(void* object, int offset)
+{
+    unsigned long key = (unsigned long) object ^ ((unsigned long) offset * 2654435761u);
+
+    return (int) ((key >> 2) % FutexBuckets);
+}
@@ -0,0 +1,46 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-29 15:02:11
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-29 17:36:45
+ * @Description: futex的等待队列，用户态的锁和条件变量只在有竞争时才陷入内核(见test/usync.c)。
+ *               FutexWait在地址上的值仍等于期望值时睡眠，FutexWake唤醒在同一地址上等待的线程。
+ *               等待者按(对象, 偏移)散列到FutexBuckets个桶，每个桶一个FIFO链表，节点放在等待线程自己的内核栈上。
+ *               共享内存段中的字用(段, 段内偏移)标识，所以各进程把段映射在不同地址也能互相唤醒；
+ *               其它地址用(地址空间, 虚拟地址)标识，只在同一个地址空间内有效
+ */
+#ifndef FUTEXTABLE_H
+#define FUTEXTABLE_H
+
+#include "thread.h"
+
+#define FutexBuckets 64
+
+class FutexWaiter
+{
+    public:
+        void* object;                   //共享内存段或者地址空间
+        int offset;                     //在段内的偏移或者虚拟地址
+        Thread* thread;
+        FutexWaiter* next;
+};
+
+class FutexTable
+{
+    public:
+        FutexTable();
+
+        int wait(int addr, int expected);   //addr上的字等于expected时睡眠直到被唤醒，返回0；不等时返回-1
+        int wake(int addr, int count);      //唤醒最多count个在addr上等待的线程(先等待的先唤醒)，返回唤醒的数量
+        int getWaiterNums() {return waiterNums;}
+
+    private:
+        FutexWaiter* head[FutexBuckets];
+        FutexWaiter* tail[FutexBuckets];
+        int waiterNums;
+
+        bool getKey(int addr, void** object, int* offset);
+        int hash(void* object, int offset);
+};
+
+#endif	// FUTEXTABLE_H
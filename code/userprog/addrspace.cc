@@ -67,6 +67,21 @@ AddrSpace::AddrSpace(int threadId, char *fileName)
     NoffHeader noffH;
     unsigned int size;
 
+    this->threadId = threadId;
+    pageTable = NULL;
+    numPages = 0;
+    heapStartPage = 0;
+    breakAddr = 0;
+    exeFileId = NULL;
+    this->fileName = NULL;
+    textStartPage = textEndPage = 0;
+    sharedText = NULL;
+    mappedRegions = new List<MappedRegion*>();
+    nextMapPage = MmapStartPage;
+    stackBottomPage = StackTopPage - 1;
+    stackLimitPage = StackTopPage - divRoundUp(kernel->userStackSize, PageSize);
+    memStats = new MemoryStats(threadId, fileName);
+
     if (executable == NULL)
     {
         cerr << "Unable to open file " << fileName << "\n";
@@ -82,44 +97,208 @@ AddrSpace::AddrSpace(int threadId, char *fileName)
 #ifdef RDATA
     // how big is address space?
     size = noffH.code.size + noffH.readonlyData.size + noffH.initData.size +
-           noffH.uninitData.size + UserStackSize;
-    // we need to increase the size
-    // to leave room for the stack
+           noffH.uninitData.size;
 #else
     // how big is address space?
-    size = noffH.code.size + noffH.initData.size + noffH.uninitData.size + UserStackSize; // we need to increase the size
-                                                                                          // to leave room for the stack
+    size = noffH.code.size + noffH.initData.size + noffH.uninitData.size;
 #endif
+    // the stack lives apart from the program image, at StackTopPage
     numPages = divRoundUp(size, PageSize);
     size = numPages * PageSize;
+    heapStartPage = numPages;
+    breakAddr = size;
 
     DEBUG(dbgAddr, "Initializing address space: " << numPages << ", " << size);
 
-    this->threadId = threadId;
     exeFileId = executable;
-    pageTable = new TranslationEntry[numPages];
-
-    // Initialize thread's page table.
-    for (int i = 0; i < numPages; i++)
+    this->fileName = new char[strlen(fileName) + 1];
+    strcpy(this->fileName, fileName);
+    // The page table covers the whole virtual address space so that
+    // Mmap regions can live far above the program; tables are only
+    // allocated for pages actually touched.
+    ASSERT(numPages < stackLimitPage);
+    pageTable = new PageTable(threadId, MaxVirtPages);
+
+    // Only pages lying entirely inside the code segment can be shared;
+    // a page that also holds data must stay private to this address space.
+    textStartPage = divRoundUp(noffH.code.virtualAddr, PageSize);
+    textEndPage = (noffH.code.virtualAddr + noffH.code.size) / PageSize;
+    if (textEndPage < textStartPage)
     {
-        pageTable[i].virtualPage = i;
-        pageTable[i].physicalPage = -1;
-        pageTable[i].valid = FALSE;
-        pageTable[i].readOnly = FALSE;
-        pageTable[i].use = FALSE;
-        pageTable[i].dirty = FALSE;
+        textEndPage = textStartPage;
     }
 }
+
+//----------------------------------------------------------------------
+// AddrSpace::AddrSpace
+// 	Create a copy of the address space "parent" for a forked process.
+//	The page table and swap slots are copied entry by entry; the
+//	caller is responsible for sharing the frames and swap slots
+//	(reference counts, read-only marking) and for attaching the
+//	shared text segment.
+//----------------------------------------------------------------------
+
+AddrSpace::AddrSpace(int threadId, AddrSpace *parent)
+{
+    this->threadId = threadId;
+    numPages = parent->numPages;
+    heapStartPage = parent->heapStartPage;
+    breakAddr = parent->breakAddr;
+    stackBottomPage = parent->stackBottomPage;
+    stackLimitPage = parent->stackLimitPage;
+    textStartPage = parent->textStartPage;
+    textEndPage = parent->textEndPage;
+    sharedText = NULL;
+    mappedRegions = new List<MappedRegion*>();	// Mmap regions are not inherited
+    nextMapPage = MmapStartPage;
+    memStats = new MemoryStats(threadId, parent->fileName);
+
+    fileName = new char[strlen(parent->fileName) + 1];
+    strcpy(fileName, parent->fileName);
+    exeFileId = kernel->fileSystem->Open(fileName);
+    ASSERT(exeFileId != NULL);
+
+    pageTable = new PageTable(threadId, parent->pageTable);
+}
+
 //----------------------------------------------------------------------
 // AddrSpace::~AddrSpace
 // 	Dealloate an address space.
-// 该地址空间所用物理页面的清零在VirtMemManager::deleteAddrSpace()中完成
+// 该地址空间所用物理页面的清零以及共享代码段的解除映射在VirtMemManager::deleteAddrSpace()中完成
 //----------------------------------------------------------------------
 
 AddrSpace::~AddrSpace()
 {
     delete pageTable;
     delete exeFileId;
+    delete [] fileName;
+    delete memStats;
+    while (!mappedRegions->IsEmpty())
+    {
+        delete mappedRegions->RemoveFront();
+    }
+    delete mappedRegions;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::growStack
+// 	Extend the stack down to virtual page "vpn" after a fault there.
+//	Only the page right below the stack, or memory the program has
+//	already claimed by moving "stackPointer" down, counts as stack;
+//	anything else, and anything below stackLimitPage, is a bad address.
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::growStack(int vpn, int stackPointer)
+{
+    if (vpn < stackLimitPage || vpn >= stackBottomPage)
+    {
+        return FALSE;
+    }
+    if (vpn < stackBottomPage - 1 && vpn < (int)((unsigned)stackPointer / PageSize))
+    {
+        return FALSE;
+    }
+
+    DEBUG(dbgAddr, "Grow stack from page " << stackBottomPage << " down to " << vpn);
+    stackBottomPage = vpn;
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::setBreak
+// 	Move the end of the heap to "newBreak".  The heap may not shrink
+//	below the loaded image nor grow into the guard page below the
+//	stack.  Pages that fall out of the heap must be released by the
+//	caller (see MemoryManager::sbrk).
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::setBreak(int newBreak)
+{
+    if (newBreak < heapStartPage * PageSize || divRoundUp(newBreak, PageSize) >= stackLimitPage - 1)
+    {
+        return FALSE;
+    }
+
+    breakAddr = newBreak;
+    numPages = divRoundUp(newBreak, PageSize);
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::findMappedRegion
+// 	Return the Mmap region containing virtual page "vpn", or NULL.
+//----------------------------------------------------------------------
+
+MappedRegion *
+AddrSpace::findMappedRegion(int vpn)
+{
+    ListIterator<MappedRegion *> iter(mappedRegions);
+
+    for (; !iter.IsDone(); iter.Next())
+    {
+        if (iter.Item()->contains(vpn))
+        {
+            return iter.Item();
+        }
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::addMappedRegion
+// 	Reserve virtual pages for "length" bytes of "file" starting at
+//	"fileOffset".  The region takes over the OpenFile.  Returns NULL
+//	if the address space is full.
+//----------------------------------------------------------------------
+
+MappedRegion *
+AddrSpace::addMappedRegion(OpenFile *file, int fileOffset, int length)
+{
+    int pages = divRoundUp(length, PageSize);
+
+    if (nextMapPage + pages > MaxVirtPages)
+    {
+        return NULL;
+    }
+
+    MappedRegion *region = new MappedRegion(nextMapPage, file, fileOffset, length);
+    nextMapPage += pages;
+    mappedRegions->Append(region);
+    return region;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::addSharedRegion
+// 	Reserve virtual pages for the shared-memory segment "segment".
+//	Returns NULL if the address space is full.
+//----------------------------------------------------------------------
+
+MappedRegion *
+AddrSpace::addSharedRegion(SharedSegment *segment)
+{
+    if (nextMapPage + segment->getNumPages() > MaxVirtPages)
+    {
+        return NULL;
+    }
+
+    MappedRegion *region = new MappedRegion(nextMapPage, segment);
+    nextMapPage += segment->getNumPages();
+    mappedRegions->Append(region);
+    return region;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::removeMappedRegion
+// 	Forget about "region"; the caller has already released its pages
+//	and is responsible for deleting it.
+//----------------------------------------------------------------------
+
+void
+AddrSpace::removeMappedRegion(MappedRegion *region)
+{
+    mappedRegions->Remove(region);
 }
 
 //----------------------------------------------------------------------
@@ -174,11 +353,11 @@ void AddrSpace::InitRegisters()
     // after start will be at virtual address four.
     machine->WriteRegister(NextPCReg, 4);
 
-    // Set the stack register to the end of the address space, where we
-    // allocated the stack; but subtract off a bit, to make sure we don't
-    // accidentally reference off the end!
-    machine->WriteRegister(StackReg, numPages * PageSize - 16);
-    DEBUG(dbgAddr, "Initializing stack pointer: " << numPages * PageSize - 16);
+    // Set the stack register to the top of the stack region; but
+    // subtract off a bit, to make sure we don't accidentally reference
+    // off the end!
+    machine->WriteRegister(StackReg, StackTopPage * PageSize - 16);
+    DEBUG(dbgAddr, "Initializing stack pointer: " << StackTopPage * PageSize - 16);
 }
 
 //----------------------------------------------------------------------
@@ -204,7 +383,6 @@ void AddrSpace::SaveState()
 void AddrSpace::RestoreState()
 {
     kernel->machine->pageTable = pageTable;
-    kernel->machine->pageTableSize = numPages;
 }
 
 //----------------------------------------------------------------------
@@ -223,19 +401,23 @@ AddrSpace::Translate(unsigned int vaddr, unsigned int *paddr, int isReadWrite)
     unsigned int vpn = vaddr / PageSize;
     unsigned int offset = vaddr % PageSize;
 
-    if (vpn >= NumVirtualPages)
+    if (vpn >= numPages)
     {
         return AddressErrorException;
     }
 
-    pte = &pageTable[vpn];
+    pte = pageTable->lookup(vpn);
+    if (pte == NULL || !pte->isValid())
+    {
+        return PageFaultException;
+    }
 
-    if (isReadWrite && pte->readOnly)
+    if (isReadWrite && pte->isReadOnly())
     {
         return ReadOnlyException;
     }
 
-    pfn = pte->physicalPage;
+    pfn = pte->getPhysicalPage();
 
     // if the pageFrame is too big, there is something really wrong!
     // An invalid translation was loaded into the page table or TLB.
@@ -245,10 +427,10 @@ AddrSpace::Translate(unsigned int vaddr, unsigned int *paddr, int isReadWrite)
         return BusErrorException;
     }
 
-    pte->use = TRUE; // set the use, dirty bits
+    pte->setUsed(TRUE); // set the use, dirty bits
 
     if (isReadWrite)
-        pte->dirty = TRUE;
+        pte->setDirty(TRUE);
 
     *paddr = pfn * PageSize + offset;
 
@@ -2,7 +2,7 @@
  * @Author: Lollipop
  * @Date: 2019-11-03 21:19:35
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 13:47:41
+ * @LastEditTime: 2019-11-16 16:21:03
  * @Description: 
  */
 // addrspace.h 
@@ -25,12 +25,26 @@
 #include "noff.h"
 #include "translate.h"
 #include "machine.h"
+#include "SharedSegment.h"
+#include "MappedRegion.h"
+#include "MemoryStats.h"
+#include "list.h"
 
-#define UserStackSize		1024 	// increase this as necessary!
+#define UserStackSize		(8 * 1024)	// Default for the largest the stack
+					// may grow (nachos -ss); it starts
+					// out as a single page
+#define MmapStartPage		(MaxVirtPages / 2)	// Mmap and shared-memory
+					// regions are placed
+					// from here up, far above the program
+#define StackTopPage		(MmapStartPage - 1)	// The stack grows down
+					// from here; the page above stays unmapped
 
 class AddrSpace {
   public:
     AddrSpace(int threadId, char* fileName);
+    AddrSpace(int threadId, AddrSpace* parent);	// Copy the layout of _parent_;
+					// frames are shared copy-on-write
+					// by VirtMemManager::forkAddrSpace()
     ~AddrSpace();			// De-allocate an address space
 
     void Execute();             	// Run a program
@@ -40,10 +54,55 @@ class AddrSpace {
     void SaveState();			// Save/restore address space-specific
     void RestoreState();		// info on a context switch
 
-    TranslationEntry* getPageTable() {return pageTable;}
+    PageTable* getPageTable() {return pageTable;}
     int getNumPages() {return numPages;}
 
     OpenFile* getExeFileId() {return exeFileId;}
+    char* getFileName() {return fileName;}
+    int getThreadId() {return threadId;}
+
+    // Code pages are read-only and shared by every address space
+    // running the same executable (see VirtMemManager).
+    bool isTextPage(int vpn) {return vpn >= textStartPage && vpn < textEndPage;}
+    int getTextStartPage() {return textStartPage;}
+    int getTextPageNums() {return textEndPage - textStartPage;}
+    SharedSegment* getSharedText() {return sharedText;}
+    void setSharedText(SharedSegment* text) {sharedText = text;}
+
+    // The stack occupies [stackBottomPage, StackTopPage).  A fault on
+    // the page just below it, or anywhere above the stack pointer, grows
+    // it down to the faulting page, but not below stackLimitPage.
+    bool isStackPage(int vpn) {return vpn >= stackBottomPage && vpn < StackTopPage;}
+    bool growStack(int vpn, int stackPointer);
+
+    // The heap runs from the end of the loaded image up to the break
+    // and is moved by Sbrk.  Its pages are zero-filled on first touch.
+    int getBreak() {return breakAddr;}
+    bool setBreak(int newBreak);	// FALSE if it would run into the
+					// stack's guard page
+    int getHeapStartPage() {return heapStartPage;}
+
+    // Pages backed by the executable, zero fill and swap, as opposed to
+    // Mmap and shared-memory regions.
+    bool isPrivatePage(int vpn) {return vpn < (int)numPages || isStackPage(vpn);}
+    int getStackBottomPage() {return stackBottomPage;}
+
+    // Swap slot holding the latest copy of a page that is not
+    // resident, -1 if the page should be loaded from the executable.
+    int getSwapSlot(int vpn) {return pageTable->getSwapSlot(vpn);}
+    void setSwapSlot(int vpn, int slot) {pageTable->setSwapSlot(vpn, slot);}
+
+    // Files mapped with Mmap and attached shared-memory segments.
+    // Pages outside the program image and outside every region are
+    // unmapped.
+    MappedRegion* findMappedRegion(int vpn);
+    MappedRegion* addMappedRegion(OpenFile* file, int fileOffset, int length);
+    MappedRegion* addSharedRegion(SharedSegment* segment);
+    void removeMappedRegion(MappedRegion* region);
+    List<MappedRegion*>* getMappedRegions() {return mappedRegions;}
+
+    // Paging counters of this address space, kept by the MemoryManager.
+    MemoryStats* getMemoryStats() {return memStats;}
 
     // Translate virtual address _vaddr_
     // to physical address _paddr_. _mode_
@@ -51,11 +110,28 @@ class AddrSpace {
     ExceptionType Translate(unsigned int vaddr, unsigned int *paddr, int mode);
 
   private:
-    TranslationEntry *pageTable;
+    PageTable *pageTable;		// Second level tables are allocated
+					// on the first fault in their range
 
     int threadId;
-    unsigned int numPages;		// Number of pages in the virtual address space
+    unsigned int numPages;		// Number of pages in the program image,
+					// heap included
+    int heapStartPage;			// First page past the loaded image
+    int breakAddr;			// End of the heap
+    int stackBottomPage;		// Lowest page of the stack
+    int stackLimitPage;			// Lowest page of a full stack, from
+					// the kernel's -ss stack size; the page
+					// below it is a guard page, never mapped
     OpenFile* exeFileId;
+    char* fileName;
+
+    int textStartPage;			// [textStartPage, textEndPage) are pages
+    int textEndPage;			// entirely inside the code segment
+    SharedSegment* sharedText;
+
+    List<MappedRegion*>* mappedRegions;
+    int nextMapPage;			// Start of the next Mmap region
+    MemoryStats* memStats;
     
     void InitRegisters();		// Initialize user-level CPU registers,
 					// before jumping to user code
@@ -26,7 +26,9 @@
 #include "syscall.h"
 #include "ksyscall.h"
 
-static void PageFaultHandler();
+static bool PageFaultHandler();
+static bool ReadOnlyHandler();
+static void AdvancePC();
 //----------------------------------------------------------------------
 // ExceptionHandler
 // 	Entry point into the Nachos kernel.  Called when a user program
@@ -82,16 +84,180 @@ void ExceptionHandler(ExceptionType which)
 			kernel->machine->WriteRegister(2, (int)result);
 
 			/* Modify return point */
-			{
-				/* set previous programm counter (debugging only)*/
-				kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
+			AdvancePC();
 
-				/* set programm counter to next instruction (all Instructions are 4 byte wide)*/
-				kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_Fork:
+			DEBUG(dbgSys, "Fork from thread " << kernel->currentThread->getPid() << "\n");
+
+			/* The child copies the registers, so advance the PC first */
+			AdvancePC();
+
+			result = SysFork();
+
+			DEBUG(dbgSys, "Fork returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_Mmap:
+			DEBUG(dbgSys, "Mmap " << kernel->machine->ReadRegister(4) << ", offset " << kernel->machine->ReadRegister(5) << ", length " << kernel->machine->ReadRegister(6) << "\n");
+
+			result = SysMmap(/* char *name */ (int)kernel->machine->ReadRegister(4),
+							 /* int offset */ (int)kernel->machine->ReadRegister(5),
+							 /* int length */ (int)kernel->machine->ReadRegister(6));
+
+			DEBUG(dbgSys, "Mmap returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_Munmap:
+			DEBUG(dbgSys, "Munmap " << kernel->machine->ReadRegister(4) << "\n");
+
+			result = SysMunmap(/* int addr */ (int)kernel->machine->ReadRegister(4));
+
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_ShmCreate:
+			DEBUG(dbgSys, "ShmCreate " << kernel->machine->ReadRegister(4) << ", size " << kernel->machine->ReadRegister(5) << "\n");
+
+			result = SysShmCreate(/* char *name */ (int)kernel->machine->ReadRegister(4),
+								  /* int size */ (int)kernel->machine->ReadRegister(5));
+
+			DEBUG(dbgSys, "ShmCreate returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_ShmAttach:
+			DEBUG(dbgSys, "ShmAttach " << kernel->machine->ReadRegister(4) << "\n");
+
+			result = SysShmAttach(/* char *name */ (int)kernel->machine->ReadRegister(4));
+
+			DEBUG(dbgSys, "ShmAttach returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_ShmDetach:
+			DEBUG(dbgSys, "ShmDetach " << kernel->machine->ReadRegister(4) << "\n");
+
+			result = SysShmDetach(/* int addr */ (int)kernel->machine->ReadRegister(4));
+
+			DEBUG(dbgSys, "ShmDetach returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_Sbrk:
+			DEBUG(dbgSys, "Sbrk " << kernel->machine->ReadRegister(4) << "\n");
 
-				/* set next programm counter for brach execution */
-				kernel->machine->WriteRegister(NextPCReg, kernel->machine->ReadRegister(PCReg) + 4);
-			}
+			result = SysSbrk(/* int increment */ (int)kernel->machine->ReadRegister(4));
+
+			DEBUG(dbgSys, "Sbrk returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_MemStat:
+			DEBUG(dbgSys, "MemStat " << kernel->machine->ReadRegister(4) << ", counter " << kernel->machine->ReadRegister(5) << "\n");
+
+			result = SysMemStat(/* int id */ (int)kernel->machine->ReadRegister(4),
+							   /* int which */ (int)kernel->machine->ReadRegister(5));
+
+			DEBUG(dbgSys, "MemStat returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_SetTickets:
+			DEBUG(dbgSys, "SetTickets " << kernel->machine->ReadRegister(4) << ", " << kernel->machine->ReadRegister(5) << " tickets\n");
+
+			result = SysSetTickets(/* int id */ (int)kernel->machine->ReadRegister(4),
+								   /* int tickets */ (int)kernel->machine->ReadRegister(5));
+
+			DEBUG(dbgSys, "SetTickets returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_FutexWait:
+			DEBUG(dbgSys, "FutexWait " << kernel->machine->ReadRegister(4) << ", expecting " << kernel->machine->ReadRegister(5) << "\n");
+
+			result = SysFutexWait(/* int *addr */ (int)kernel->machine->ReadRegister(4),
+								  /* int expected */ (int)kernel->machine->ReadRegister(5));
+
+			DEBUG(dbgSys, "FutexWait returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
+
+			return;
+
+			ASSERTNOTREACHED();
+
+			break;
+
+		case SC_FutexWake:
+			DEBUG(dbgSys, "FutexWake " << kernel->machine->ReadRegister(4) << ", count " << kernel->machine->ReadRegister(5) << "\n");
+
+			result = SysFutexWake(/* int *addr */ (int)kernel->machine->ReadRegister(4),
+								  /* int count */ (int)kernel->machine->ReadRegister(5));
+
+			DEBUG(dbgSys, "FutexWake returning with " << result << "\n");
+			kernel->machine->WriteRegister(2, (int)result);
+			AdvancePC();
 
 			return;
 
@@ -105,8 +271,16 @@ void ExceptionHandler(ExceptionType which)
 		}
 		break;
 	case PageFaultException:
-		PageFaultHandler();
-		return;
+		if (PageFaultHandler())
+			return;
+		cerr << "Illegal address " << kernel->machine->ReadRegister(BadVAddrReg) << "\n";
+		break;
+
+	case ReadOnlyException:
+		if (ReadOnlyHandler())
+			return;
+		cerr << "Write to read-only page at " << kernel->machine->ReadRegister(BadVAddrReg) << "\n";
+		break;
 		
 
 	default:
@@ -116,12 +290,54 @@ void ExceptionHandler(ExceptionType which)
 	ASSERTNOTREACHED();
 }
 
-static void PageFaultHandler()
+//----------------------------------------------------------------------
+// PageFaultHandler
+// 	Bring in the page at BadVAddr.  Returns FALSE if the address is
+//	not part of the program image, the stack (which grows here on
+//	demand) or any Mmap or shared-memory region.
+//----------------------------------------------------------------------
+
+static bool PageFaultHandler()
 {
 	int addr = kernel->machine->ReadRegister(BadVAddrReg);
 	int vpn = (unsigned) addr / PageSize;
 	
-	kernel->memoryManager->pageFaultHandler(vpn);
+	if (!kernel->memoryManager->pageFaultHandler(vpn))
+		return FALSE;
 	
 	kernel->stats->numPageFaults++;
+	return TRUE;
+}
+
+//----------------------------------------------------------------------
+// ReadOnlyHandler
+// 	A write to a read-only page is either a copy-on-write fault on a
+//	page shared after Fork (handled by the memory manager, and the
+//	instruction is restarted), or a genuine protection violation.
+//----------------------------------------------------------------------
+
+static bool ReadOnlyHandler()
+{
+	int addr = kernel->machine->ReadRegister(BadVAddrReg);
+	int vpn = (unsigned) addr / PageSize;
+
+	return kernel->memoryManager->readOnlyFaultHandler(vpn);
+}
+
+//----------------------------------------------------------------------
+// AdvancePC
+// 	Step over the syscall instruction, so that the user program
+//	continues after it rather than making the same call forever.
+//----------------------------------------------------------------------
+
+static void AdvancePC()
+{
+	/* set previous programm counter (debugging only)*/
+	kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
+
+	/* set programm counter to next instruction (all Instructions are 4 byte wide)*/
+	kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
+
+	/* set next programm counter for brach execution */
+	kernel->machine->WriteRegister(NextPCReg, kernel->machine->ReadRegister(PCReg) + 4);
 }
@@ -27,7 +27,143 @@ int SysAdd(int op1, int op2)
   return op1 + op2;
 }
 
+#define MaxUserStringLength 256
 
+/* Copy a NUL-terminated string out of user memory into "buffer".
+ * Returns FALSE if it does not fit in "size" bytes. */
+static bool ReadUserString(int addr, char *buffer, int size)
+{
+  for (int i = 0; i < size; i++)
+  {
+    int c;
+    if (!kernel->machine->ReadMem(addr + i, 1, &c))
+      return FALSE;
+    buffer[i] = (char)c;
+    if (c == '\0')
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* First thing a forked child process runs: resume the user program
+ * from the register state copied from the parent. */
+static void ForkedProcess(void *arg)
+{
+  kernel->currentThread->RestoreUserState();
+  kernel->currentThread->space->RestoreState();
+  kernel->machine->Run();
+
+  ASSERTNOTREACHED();
+}
+
+/* The caller must have advanced the PC past the syscall already,
+ * so that the child resumes after Fork() too. */
+int SysFork()
+{
+  Thread *parent = kernel->currentThread;
+  Thread *child = kernel->threadManager->createThread(parent->getName(), parent->getUid());
+  if (child == NULL)
+    return -1;
+
+  AddrSpace *space = kernel->memoryManager->forkAddrSpace(parent->getPid(), child->getPid());
+  if (space == NULL)
+  {
+    kernel->threadManager->deleteThread(child);
+    return -1;
+  }
+
+  child->space = space;
+  child->setPriority(parent->getBasePriority());
+  child->setTickets(parent->getTickets());
+  child->SaveUserState();
+  child->SetUserRegister(2, 0);
+  child->Fork(ForkedProcess, NULL);
+
+  return child->getPid();
+}
+
+
+
+
+
+
+int SysMmap(int nameAddr, int offset, int length)
+{
+  char name[MaxUserStringLength];
+
+  if (!ReadUserString(nameAddr, name, MaxUserStringLength))
+    return -1;
+  return kernel->memoryManager->mapFile(name, offset, length);
+}
+
+
+int SysMunmap(int addr)
+{
+  return kernel->memoryManager->unmapFile(addr) ? 0 : -1;
+}
+
+
+int SysShmCreate(int nameAddr, int size)
+{
+  char name[MaxUserStringLength];
+
+  if (!ReadUserString(nameAddr, name, MaxUserStringLength))
+    return -1;
+  return kernel->memoryManager->createSharedMemory(name, size);
+}
+
+
+int SysShmAttach(int nameAddr)
+{
+  char name[MaxUserStringLength];
+
+  if (!ReadUserString(nameAddr, name, MaxUserStringLength))
+    return -1;
+  return kernel->memoryManager->attachSharedMemory(name);
+}
+
+
+int SysShmDetach(int addr)
+{
+  return kernel->memoryManager->detachSharedMemory(addr) ? 0 : -1;
+}
+
+
+int SysSbrk(int increment)
+{
+  return kernel->memoryManager->sbrk(increment);
+}
+
+
+int SysMemStat(int id, int which)
+{
+  return kernel->memoryManager->getMemoryStat(id, which);
+}
+
+
+int SysSetTickets(int id, int tickets)
+{
+  Thread *thread = (id == -1) ? kernel->currentThread : kernel->threadManager->getThreadPtr(id);
+  int old;
+
+  if (thread == NULL || tickets < 1 || tickets > MaxTickets)
+    return -1;
+  old = thread->getTickets();
+  thread->setTickets(tickets);
+  return old;
+}
+
+
+int SysFutexWait(int addr, int expected)
+{
+  return kernel->futexTable->wait(addr, expected);
+}
+
+
+int SysFutexWake(int addr, int count)
+{
+  return kernel->futexTable->wake(addr, count);
+}
 
 
 
@@ -39,6 +39,17 @@
 #define SC_getThreadID  18
 #define SC_Ipc          19
 #define SC_Clock        20
+#define SC_Fork         21
+#define SC_Mmap         22
+#define SC_Munmap       23
+#define SC_ShmCreate    24
+#define SC_ShmAttach    25
+#define SC_ShmDetach    26
+#define SC_Sbrk         27
+#define SC_MemStat      28
+#define SC_SetTickets   29
+#define SC_FutexWait    30
+#define SC_FutexWake    31
 
 #define SC_Add		42
 
@@ -90,6 +101,13 @@ SpaceId ExecV(int argc, char* argv[]);
  * Return the exit status.
  */
 int Join(SpaceId id); 	
+
+/* Duplicate the calling address space into a new process, UNIX style.
+ * Pages are shared copy-on-write between the two processes.
+ * Returns the SpaceId of the child in the parent, 0 in the child,
+ * and a negative value if the process could not be created.
+ */
+SpaceId Fork();
  
 
 /* File system operations: Create, Remove, Open, Read, Write, Close
@@ -160,6 +178,102 @@ int Delete(char* name);
 int Close(OpenFileId id);
 
 
+/* Memory-mapped files.
+ *
+ * Map "length" bytes of the file "name", starting at byte "offset",
+ * into the address space.  Pages are read from the file on first
+ * access; modified pages are written back to the file when they are
+ * evicted, on Munmap, and when the address space goes away.  The
+ * mapping is clipped at the end of the file and cannot grow it.
+ * Returns the virtual address of the mapping, or -1 on failure.
+ */
+int Mmap(char *name, int offset, int length);
+
+/* Remove the mapping that Mmap returned at "addr".
+ * Returns 0 on success, -1 if there is no such mapping.
+ */
+int Munmap(int addr);
+
+
+/* Named shared memory.
+ *
+ * ShmCreate makes a zero-filled segment of "size" bytes called "name"
+ * and attaches it; ShmAttach attaches an existing segment.  Every
+ * attached address space sees the same physical pages.  A segment
+ * disappears when the last address space detaches or exits, and it is
+ * not inherited across Fork.  Both return the virtual address of the
+ * segment, or -1 on failure.
+ */
+int ShmCreate(char *name, int size);
+int ShmAttach(char *name);
+
+/* Detach the segment that ShmCreate or ShmAttach returned at "addr".
+ * Returns 0 on success, -1 if there is no such segment.
+ */
+int ShmDetach(int addr);
+
+
+/* Move the end of the heap by "increment" bytes (which may be
+ * negative).  The heap starts right after the program's data; new
+ * pages are zero-filled when first touched.  Returns the old end of
+ * the heap, i.e. the start of the new memory, or -1 if the heap would
+ * run into the stack.
+ */
+int Sbrk(int increment);
+
+
+/* Virtual memory statistics.
+ *
+ * Return counter "which" of the address space "id", or of the whole
+ * system if "id" is -1.  Major faults had to read the disk; minor
+ * faults were served from memory (zero fill, a shared page already
+ * resident, the compressed swap cache, copy-on-write).  Returns -1 if
+ * there is no such address space or counter.
+ */
+#define MEMSTAT_RESIDENT	0	/* pages currently mapped */
+#define MEMSTAT_MAJOR_FAULTS	1
+#define MEMSTAT_MINOR_FAULTS	2
+#define MEMSTAT_EVICTIONS	3	/* pages evicted */
+#define MEMSTAT_WRITEBACKS	4	/* dirty pages written back */
+#define MEMSTAT_SWAP_INS	5	/* pages read back from swap */
+#define MEMSTAT_ZERO_FILLS	6	/* pages zero-filled on first touch */
+
+int MemStat(SpaceId id, int which);
+
+
+/* Give process "id", or the caller if "id" is -1, "tickets" tickets.
+ * Under stride and lottery scheduling (nachos -sp stride|lottery)
+ * runnable processes share the CPU in proportion to their tickets;
+ * the other policies ignore them.  A forked child starts with the
+ * tickets of its parent.  Returns the previous number of tickets, or
+ * -1 if there is no such process or "tickets" is not between 1 and
+ * MAX_TICKETS.
+ */
+#define MAX_TICKETS	10000
+
+int SetTickets(SpaceId id, int tickets);
+
+
+/* Futexes: the kernel half of user-level locks (see test/usync.h),
+ * which only trap into the kernel when they have to wait or to wake
+ * somebody up.
+ *
+ * FutexWait puts the caller to sleep until a FutexWake on "addr", but
+ * only if the word at "addr" still holds "expected"; the test and
+ * going to sleep are atomic, so a wakeup between the caller's own
+ * test and the call cannot be lost.  Returns 0 once woken, -1 if the
+ * word had changed or "addr" is not word aligned.
+ *
+ * FutexWake wakes up to "count" threads waiting on "addr", longest
+ * waiting first, and returns how many it woke.
+ *
+ * A word in a shared-memory segment is the same futex in every
+ * address space the segment is attached to, at whatever address.
+ */
+int FutexWait(int *addr, int expected);
+int FutexWake(int *addr, int count);
+
+
 /* User-level thread operations: Fork and Yield.  To allow multiple
  * threads to run within a user program. 
  *
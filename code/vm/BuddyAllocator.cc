@@ -0,0 +1,200 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-21 10:31:52
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-21 16:42:30
+ * @Description:
+ */
+#include "BuddyAllocator.h"
+#include "debug.h"
+
+BuddyAllocator::BuddyAllocator(int pageNums)
+{
+    ASSERT(pageNums > 0);
+
+    this->pageNums = pageNums;
+    freeNums = 0;
+    allocatedMap = new Bitmap(pageNums);
+    freeOrder = new int[pageNums];
+    allocOrder = new int[pageNums];
+    next = new int[pageNums];
+    prev = new int[pageNums];
+
+    for (int i = 0; i < pageNums; i++)
+    {
+        freeOrder[i] = -1;
+        allocOrder[i] = -1;
+    }
+    for (int order = 0; order <= BuddyMaxOrder; order++)
+    {
+        freeHead[order] = -1;
+        freeBlockNums[order] = 0;
+    }
+
+    //从低地址开始，每次放入一个不越界的、对齐的最大块
+    for (int first = 0; first < pageNums; )
+    {
+        int order = BuddyMaxOrder;
+        while ((first & ((1 << order) - 1)) != 0 || first + (1 << order) > pageNums)
+        {
+            order--;
+        }
+        pushFree(first, order);
+        first += 1 << order;
+    }
+}
+
+BuddyAllocator::~BuddyAllocator()
+{
+    delete allocatedMap;
+    delete[] freeOrder;
+    delete[] allocOrder;
+    delete[] next;
+    delete[] prev;
+}
+
+void
+BuddyAllocator::pushFree(int first, int order)
+{
+    freeOrder[first] = order;
+    prev[first] = -1;
+    next[first] = freeHead[order];
+    if (freeHead[order] != -1)
+    {
+        prev[freeHead[order]] = first;
+    }
+    freeHead[order] = first;
+    freeBlockNums[order]++;
+    freeNums += 1 << order;
+}
+
+void
+BuddyAllocator::removeFree(int first, int order)
+{
+    ASSERT(freeOrder[first] == order);
+
+    if (prev[first] != -1)
+    {
+        next[prev[first]] = next[first];
+    }
+    else
+    {
+        freeHead[order] = next[first];
+    }
+    if (next[first] != -1)
+    {
+        prev[next[first]] = prev[first];
+    }
+    freeOrder[first] = -1;
+    freeBlockNums[order]--;
+    freeNums -= 1 << order;
+}
+
+/**
+ * @description: 找到阶数不小于order的最小空闲块，多余的部分逐次对半拆分放回低阶的空闲链表
+ * @param {int order}
+ * @return: 块的第一个页框号，没有足够大的空闲块时返回-1
+ */
+int
+BuddyAllocator::alloc(int order)
+{
+    if (order < 0 || order > BuddyMaxOrder)
+    {
+        return -1;
+    }
+
+    int current = order;
+    while (current <= BuddyMaxOrder && freeHead[current] == -1)
+    {
+        current++;
+    }
+    if (current > BuddyMaxOrder)
+    {
+        return -1;
+    }
+
+    int first = freeHead[current];
+    removeFree(first, current);
+    while (current > order)
+    {
+        current--;
+        pushFree(first + (1 << current), current);
+    }
+
+    allocOrder[first] = order;
+    for (int i = first; i < first + (1 << order); i++)
+    {
+        allocatedMap->Mark(i);
+    }
+    return first;
+}
+
+/**
+ * @description: 释放一个块，伙伴块也空闲时合并成高一阶的块，直到伙伴不空闲或者达到最大阶
+ * @param {int firstPage}
+ * @return:
+ */
+void
+BuddyAllocator::free(int firstPage)
+{
+    ASSERT(firstPage >= 0 && firstPage < pageNums && allocOrder[firstPage] != -1);
+
+    int order = allocOrder[firstPage];
+    allocOrder[firstPage] = -1;
+    for (int i = firstPage; i < firstPage + (1 << order); i++)
+    {
+        allocatedMap->Clear(i);
+    }
+
+    int first = firstPage;
+    while (order < BuddyMaxOrder)
+    {
+        int buddy = first ^ (1 << order);
+        if (buddy >= pageNums || freeOrder[buddy] != order)
+        {
+            break;
+        }
+        removeFree(buddy, order);
+        first = min(first, buddy);
+        order++;
+    }
+    pushFree(first, order);
+}
+
+int
+BuddyAllocator::getLargestFreeOrder()
+{
+    for (int order = BuddyMaxOrder; order >= 0; order--)
+    {
+        if (freeHead[order] != -1)
+        {
+            return order;
+        }
+    }
+    return -1;
+}
+
+int
+BuddyAllocator::getFragmentation()
+{
+    int largest = getLargestFreeOrder();
+    if (largest == -1)
+    {
+        return 0;
+    }
+    return 100 - (100 << largest) / freeNums;
+}
+
+void
+BuddyAllocator::Print()
+{
+    printf("Frames: %d total, %d free, largest free block %d, fragmentation %d%%\n",
+           pageNums, freeNums, getLargestFreeOrder() == -1 ? 0 : 1 << getLargestFreeOrder(),
+           getFragmentation());
+    printf("Free blocks by order:");
+    for (int order = 0; order <= BuddyMaxOrder; order++)
+    {
+        printf(" %d", freeBlockNums[order]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,48 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-21 10:05:16
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-21 16:42:30
+ * @Description: 伙伴系统物理页框分配器。空闲页框按2^order大小、2^order对齐的块组织，每一阶一个双向空闲链表，
+ *               分配时从最小的够用的块开始拆分，释放时和伙伴块(first ^ 2^order)合并，分配和释放都是O(log n)。
+ *               页框总数不是2的幂时，初始化时把页框切成若干个尽量大的对齐块
+ */
+#ifndef BUDDYALLOCATOR_H
+#define BUDDYALLOCATOR_H
+
+#include "bitmap.h"
+
+#define BuddyMaxOrder 10                //最大的块为1024个页框
+
+class BuddyAllocator
+{
+    public:
+        BuddyAllocator(int pageNums);
+        ~BuddyAllocator();
+
+        int alloc(int order);           //分配2^order个连续的页框，返回第一个页框号，没有足够大的块时返回-1
+        void free(int firstPage);       //释放alloc返回的块，块的大小由分配时的阶数决定
+        bool isAllocated(int page) {return allocatedMap->Test(page);}
+
+        int getFreeNums() {return freeNums;}
+        int getFreeBlockNums(int order) {return freeBlockNums[order];}
+        int getLargestFreeOrder();      //最大的空闲块的阶数，没有空闲页框时返回-1
+        int getFragmentation();         //外部碎片率(百分比)：空闲页框中不属于最大空闲块的比例
+        void Print();
+
+    private:
+        int pageNums;
+        int freeNums;
+        Bitmap* allocatedMap;           //每个页框是否已经分配
+        int* freeOrder;                 //空闲块的第一个页框记录块的阶数，其它页框为-1
+        int* allocOrder;                //已分配块的第一个页框记录块的阶数，其它页框为-1
+        int* next;                      //空闲链表，以块的第一个页框号为下标
+        int* prev;
+        int freeHead[BuddyMaxOrder + 1];
+        int freeBlockNums[BuddyMaxOrder + 1];
+
+        void pushFree(int first, int order);
+        void removeFree(int first, int order);
+};
+
+#endif	// BUDDYALLOCATOR_H
@@ -0,0 +1,54 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-20 10:15:40
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-20 17:26:31
+ * @Description: 
+ */
+#include "MappedRegion.h"
+#include "main.h"
+
+MappedRegion::MappedRegion(int startPage, OpenFile* file, int fileOffset, int length)
+{
+    ASSERT(file != NULL && fileOffset >= 0 && length > 0);
+
+    this->startPage = startPage;
+    this->numPages = divRoundUp(length, PageSize);
+    this->file = file;
+    this->segment = NULL;
+    this->fileOffset = fileOffset;
+    this->length = length;
+}
+
+MappedRegion::MappedRegion(int startPage, SharedSegment* segment)
+{
+    ASSERT(segment != NULL);
+
+    this->startPage = startPage;
+    this->numPages = segment->getNumPages();
+    this->file = NULL;
+    this->segment = segment;
+    this->fileOffset = 0;
+    this->length = numPages * PageSize;
+}
+
+MappedRegion::~MappedRegion()
+{
+    delete file;
+}
+
+int
+MappedRegion::getFilePosition(int vpn)
+{
+    ASSERT(contains(vpn));
+
+    return fileOffset + (vpn - startPage) * PageSize;
+}
+
+int
+MappedRegion::getPageLength(int vpn)
+{
+    ASSERT(contains(vpn));
+
+    return min(PageSize, length - (vpn - startPage) * PageSize);
+}
@@ -0,0 +1,41 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-20 10:03:55
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-20 17:26:31
+ * @Description: 地址空间中通过Mmap映射的一段文件。页在第一次访问时从文件读入，
+ *               脏页在换出、Munmap或者进程退出时写回文件，不使用交换区。
+ *               挂接的共享内存段也是一个区域，这时file为NULL，页的内容由共享段管理
+ */
+#ifndef MAPPEDREGION_H
+#define MAPPEDREGION_H
+
+#include "filesys.h"
+#include "SharedSegment.h"
+
+class MappedRegion
+{
+    public:
+        MappedRegion(int startPage, OpenFile* file, int fileOffset, int length);
+        MappedRegion(int startPage, SharedSegment* segment);
+        ~MappedRegion();                    //关闭文件
+
+        int getStartPage() {return startPage;}
+        int getNumPages() {return numPages;}
+        bool contains(int vpn) {return vpn >= startPage && vpn < startPage + numPages;}
+
+        OpenFile* getFile() {return file;}
+        SharedSegment* getSegment() {return segment;}
+        int getFilePosition(int vpn);       //vpn在文件中对应的位置
+        int getPageLength(int vpn);         //vpn中属于文件的字节数，其余部分填零
+
+    private:
+        int startPage;
+        int numPages;
+        OpenFile* file;
+        SharedSegment* segment;
+        int fileOffset;
+        int length;
+};
+
+#endif	// MAPPEDREGION_H
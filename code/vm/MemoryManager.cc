@@ -2,23 +2,36 @@
  * @Author: Lollipop
  * @Date: 2019-11-12 14:42:14
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 14:17:36
+ * @LastEditTime: 2019-11-16 17:30:18
  * @Description: 
  */
 #include "main.h"
 #include "MemoryManager.h"
 #include "ThreadManager.h"
+#include "synch.h"
 
 MemoryManager::MemoryManager()
 {
-    virtMemManager = new VirtMemManager(THREAD_COUNT_MAX);
+    virtMemManager = new VirtMemManager(THREAD_TABLE_INIT);
     phyMemManager  = new PhyMemManager(NumPhysPages);
+    swapManager    = new SwapManager(SwapSectors);
+    pageLock       = new Lock("page lock");
+    globalStats    = new MemoryStats(-1, "total");
+    exitedStats    = new List<MemoryStats*>();
 }
 
 MemoryManager::~MemoryManager()
 {
     delete virtMemManager;
     delete phyMemManager;
+    delete swapManager;
+    delete pageLock;
+    delete globalStats;
+    while (!exitedStats->IsEmpty())
+    {
+        delete exitedStats->RemoveFront();
+    }
+    delete exitedStats;
 }
 
 AddrSpace*
@@ -33,59 +46,675 @@ MemoryManager::createAddrSpace(int threadId, char* filename)
     return virtMemManager->createAddrSpace(threadId, filename);
 }
 
+AddrSpace*
+MemoryManager::forkAddrSpace(int parentThreadId, int childThreadId)
+{
+    return virtMemManager->forkAddrSpace(parentThreadId, childThreadId);
+}
+
 void
 MemoryManager::deleteAddrSpace(int threadId)
 {
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(threadId);
+
+    //先把Mmap区域的脏页写回文件
+    if (space != NULL && !space->getMappedRegions()->IsEmpty())
+    {
+        pageLock->Acquire();
+        while (!space->getMappedRegions()->IsEmpty())
+        {
+            releaseMappedRegion(space, space->getMappedRegions()->Front());
+        }
+        pageLock->Release();
+    }
+
+    if (space != NULL)
+    {
+        MemoryStats* stats = new MemoryStats(*space->getMemoryStats());
+        stats->residentPages = 0;
+        exitedStats->Append(stats);
+    }
     virtMemManager->deleteAddrSpace(threadId);
 }
 
-void
+/**
+ * @description: 缺页处理。代码页和共享内存段的页先在共享段中查找，已经在内存中则直接映射同一个物理页框，
+ *               否则分配一个物理页框(必要时换出一页)并从磁盘读入
+ * @param {int vpn} 
+ * @return: vpn不在程序映像、栈、Mmap区域或者共享内存段中时返回FALSE
+ */
+bool
 MemoryManager::pageFaultHandler(int vpn)
 {
     int currentThreadId = kernel->currentThread->getPid();
     AddrSpace* currentThreadAddrSpace = virtMemManager->getAddrSpaceOfThread(currentThreadId);
-    TranslationEntry* currentPageTable = currentThreadAddrSpace->getPageTable();
+    int startTicks = kernel->stats->totalTicks;
+    bool major = FALSE;
+
+    //程序映像和栈之外只有Mmap映射的区域和挂接的共享内存段是合法的，栈底下面的缺页使栈向下增长
+    MappedRegion* region = NULL;
+    if (!currentThreadAddrSpace->isPrivatePage(vpn)
+        && !currentThreadAddrSpace->growStack(vpn, kernel->machine->ReadRegister(StackReg)))
+    {
+        region = currentThreadAddrSpace->findMappedRegion(vpn);
+        if (region == NULL)
+        {
+            return FALSE;
+        }
+    }
+
+    TranslationEntry* entry = currentThreadAddrSpace->getPageTable()->getEntry(vpn);
+    ASSERT(entry != NULL);
+
+    pageLock->Acquire();
+    if (!entry->isValid())
+    {
+        SharedSegment* segment = NULL;
+        int segmentPage = -1;
+        int phyPage = -1;
+
+        if (currentThreadAddrSpace->isTextPage(vpn))
+        {
+            segment = currentThreadAddrSpace->getSharedText();
+            segmentPage = vpn - currentThreadAddrSpace->getTextStartPage();
+        }
+        else if (region != NULL && region->getSegment() != NULL)
+        {
+            segment = region->getSegment();
+            segmentPage = vpn - region->getStartPage();
+        }
+        if (segment != NULL)
+        {
+            phyPage = segment->getFrame(segmentPage);
+        }
+
+        if (phyPage == -1)
+        {
+            phyPage = allocOnePage();
+            major = loadPage(currentThreadAddrSpace, vpn, phyPage);
+
+            if (segment != NULL)
+            {
+                phyMemManager->setSharedSegment(phyPage, segment, segmentPage);
+            }
+        }
+        else
+        {
+            DEBUG(dbgAddr, "Map shared page " << vpn << " of " << segment->getName() << " to frame " << phyPage);
+        }
+
+        phyMemManager->addMapping(phyPage, currentThreadAddrSpace, vpn, entry);
+        phyMemManager->updatePageWeight(phyPage);
+
+        entry->setValid(TRUE);
+        entry->setPhysicalPage(phyPage);
+        entry->setReadOnly(currentThreadAddrSpace->isTextPage(vpn));
+        entry->setUsed(FALSE);
+        entry->setDirty(FALSE);
+    }
+    currentThreadAddrSpace->getMemoryStats()->recordFault(major, kernel->stats->totalTicks - startTicks);
+    globalStats->recordFault(major, kernel->stats->totalTicks - startTicks);
+    pageLock->Release();
+
+    return TRUE;
+}
+
+/**
+ * @description: 写只读页的处理。写代码页是真正的保护错误；其它只读页是fork之后写时复制共享的页，
+ *               页框只剩当前进程一个映射者时直接恢复可写，否则复制到一个新的页框
+ * @param {int vpn} 
+ * @return: 是否是写时复制页(FALSE表示非法写)
+ */
+bool
+MemoryManager::readOnlyFaultHandler(int vpn)
+{
+    int currentThreadId = kernel->currentThread->getPid();
+    AddrSpace* currentThreadAddrSpace = virtMemManager->getAddrSpaceOfThread(currentThreadId);
+
+    if (currentThreadAddrSpace == NULL || vpn < 0 || !currentThreadAddrSpace->isPrivatePage(vpn)
+        || currentThreadAddrSpace->isTextPage(vpn))
+    {
+        return FALSE;
+    }
+
+    int startTicks = kernel->stats->totalTicks;
+
+    pageLock->Acquire();
+    //等锁的时候页可能已经被换出，倒排页表的表项还可能已经回收给别的页，所以拿到锁之后才查页表；
+    //页被换出时重新执行指令会先产生缺页
+    TranslationEntry* entry = currentThreadAddrSpace->getPageTable()->lookup(vpn);
+    if (entry != NULL && entry->isValid() && entry->isReadOnly())
+    {
+        int oldPage = entry->getPhysicalPage();
+
+        if (phyMemManager->getRefCount(oldPage) > 1)
+        {
+            //先保存页的内容并解除映射，分配新页框时旧页框可能被换出
+            char buffer[PageSize];
+            bcopy(&(kernel->machine->mainMemory[oldPage * PageSize]), buffer, PageSize);
+            phyMemManager->removeMapping(oldPage, currentThreadAddrSpace, vpn);
+            entry->setValid(FALSE);
+
+            int newPage = allocOnePage();
+            bcopy(buffer, &(kernel->machine->mainMemory[newPage * PageSize]), PageSize);
+            phyMemManager->addMapping(newPage, currentThreadAddrSpace, vpn, entry);
+            phyMemManager->updatePageWeight(newPage);
+
+            entry->setPhysicalPage(newPage);
+            entry->setValid(TRUE);
+            DEBUG(dbgAddr, "Copy on write: page " << vpn << " frame " << oldPage << " -> " << newPage);
+        }
+
+        //页的内容已经和交换槽中共享的副本不同，换出时必须写入私有的交换槽
+        entry->setReadOnly(FALSE);
+        entry->setDirty(TRUE);
+        #ifdef USE_TLB
+        kernel->machine->tlbManager->invalidEntry(currentThreadId, vpn);
+        #endif
+
+        currentThreadAddrSpace->getMemoryStats()->recordFault(FALSE, kernel->stats->totalTicks - startTicks);
+        globalStats->recordFault(FALSE, kernel->stats->totalTicks - startTicks);
+    }
+    pageLock->Release();
 
-    if (!currentPageTable[vpn].valid)
+    return TRUE;
+}
+
+/**
+ * @description: 把地址空间space的第vpn页读入物理页框phyPage。Mmap区域的页从映射的文件读入，
+ *               共享内存段的页从段的交换槽读入，第一次使用时填零；
+ *               页被换出过则从交换槽读入，否则从可执行文件读入，文件之外的部分(bss)、堆和栈页填零
+ * @param {AddrSpace* space, int vpn, int phyPage} 
+ * @return: 是否读了磁盘(主缺页)
+ */
+bool
+MemoryManager::loadPage(AddrSpace* space, int vpn, int phyPage)
+{
+    char* page = &(kernel->machine->mainMemory[phyPage * PageSize]);
+    int slot = space->getSwapSlot(vpn);
+    MemoryStats* stats = space->getMemoryStats();
+
+    if (!space->isPrivatePage(vpn))
     {
-        int swapPhyPage = phyMemManager->findOneEmptyPage();
+        MappedRegion* region = space->findMappedRegion(vpn);
+        SharedSegment* segment = region->getSegment();
+        bzero(page, PageSize);
 
-        // swapPhyPage == -1, 表示当前物理页框全都被占用，需要使用替换算法找到一个进行替换
-        if (swapPhyPage == -1)
+        if (segment == NULL)
+        {
+            region->getFile()->ReadAt(page, region->getPageLength(vpn), region->getFilePosition(vpn));
+            return TRUE;
+        }
+        slot = segment->getSwapSlot(vpn - region->getStartPage());
+        if (slot == -1)
         {
-            swapPhyPage = phyMemManager->swapOnePage();
-            int swapThreadId = phyMemManager->getMainThread(swapPhyPage);
-            int swapVirtPage = phyMemManager->getVirtualPage(swapPhyPage);
-            TranslationEntry* swapPageTable = virtMemManager->getAddrSpaceOfThread(swapThreadId)->getPageTable();
+            stats->zeroFills++;
+            globalStats->zeroFills++;
+            return FALSE;
+        }
+    }
+    else if (slot == -1 && vpn < space->getHeapStartPage())
+    {
+        bzero(page, PageSize);
+        space->getExeFileId()->ReadAt(page, PageSize, vpn * PageSize + sizeof(NoffHeader));
+        return TRUE;
+    }
+    else if (slot == -1)
+    {
+        bzero(page, PageSize);
+        stats->zeroFills++;
+        globalStats->zeroFills++;
+        return FALSE;
+    }
+
+    stats->swapIns++;
+    globalStats->swapIns++;
+    return swapManager->readPage(slot, page);
+}
 
-            //脏页需要写回磁盘
-            if (swapPageTable[swapVirtPage].dirty)
+/**
+ * @description: 分配一个空闲物理页框。如果当前物理页框全都被占用，使用替换算法找到一个进行替换
+ * @param none 
+ * @return: 物理页号
+ */
+int
+MemoryManager::allocOnePage()
+{
+    int phyPage = phyMemManager->findOneEmptyPage();
+
+    // phyPage == -1, 表示当前物理页框全都被占用，需要使用替换算法找到一个进行替换
+    if (phyPage == -1)
+    {
+        phyPage = phyMemManager->swapOnePage();
+        swapOutPage(phyPage);
+    }
+
+    return phyPage;
+}
+
+/**
+ * @description: 换出一个物理页框。通过反向映射找到所有映射了该页框的页表项并使其失效，
+ *               任何一个映射者的页表项是脏的，就把页写入交换区，所有映射者共享同一个交换槽。
+ *               共享内存段的页总是写入段自己的交换槽：映射者解除挂接时会带走它的脏位。
+ *               换出后页框仍然处于已分配状态
+ * @param {int phyPage} 
+ * @return: 
+ */
+void
+MemoryManager::swapOutPage(int phyPage)
+{
+    bool dirty = FALSE;
+    int slot = -1;
+    MappedRegion* region = NULL;
+    int regionPage = -1;
+    SharedSegment* segment = phyMemManager->getSharedSegment(phyPage);
+    int segmentPage = phyMemManager->getSegmentPage(phyPage);
+    ListIterator<PhyMemMapping*> iter(phyMemManager->getMappings(phyPage));
+
+    //写磁盘会阻塞，先使所有映射失效，防止换出过程中页被修改
+    for (; !iter.IsDone(); iter.Next())
+    {
+        AddrSpace* swapSpace = iter.Item()->space;
+        int swapVirtPage = iter.Item()->virtualPage;
+        TranslationEntry* swapEntry = iter.Item()->entry;
+
+        //TLB项失效时才把写命中的脏位写回页表项，所以要在读脏位之前
+        #ifdef USE_TLB
+        kernel->machine->tlbManager->invalidEntry(swapSpace->getThreadId(), swapVirtPage);
+        #endif
+        dirty = dirty || swapEntry->isDirty();
+        swapSpace->getMemoryStats()->evictions++;
+
+        swapEntry->setValid(FALSE);
+        swapSpace->getPageTable()->releaseEntry(swapVirtPage);
+    }
+
+    PhyMemMapping* mapping = phyMemManager->getMappings(phyPage)->Front();
+    AddrSpace* space = mapping->space;
+
+    //共享内存段的页写入段自己的交换槽，代码段的页直接丢弃
+    if (segment != NULL && segment != space->getSharedText())
+    {
+        slot = segment->getSwapSlot(segmentPage);
+        if (slot == -1)
+        {
+            slot = swapManager->allocSlot();
+            ASSERT(slot != -1);     //交换区已满
+            segment->setSwapSlot(segmentPage, slot);
+        }
+        dirty = TRUE;
+    }
+    //共享代码页是只读的，不会是脏页
+    else if (dirty)
+    {
+        //Mmap区域的页只有一个映射者，写回映射的文件
+        if (!space->isPrivatePage(mapping->virtualPage))
+        {
+            region = space->findMappedRegion(mapping->virtualPage);
+            regionPage = mapping->virtualPage;
+        }
+        //只有一个映射者且它独占原来的交换槽时可以直接覆盖，否则分配一个新的交换槽
+        else if (phyMemManager->getRefCount(phyPage) == 1)
+        {
+            int oldSlot = space->getSwapSlot(mapping->virtualPage);
+            if (oldSlot != -1 && swapManager->getRefCount(oldSlot) == 1)
             {
-                AddrSpace* swapThreadAddrSpace = virtMemManager->getAddrSpaceOfThread(swapThreadId);
-                OpenFile* swapFile = swapThreadAddrSpace->getExeFileId();
-                swapFile->WriteAt(&(kernel->machine->mainMemory[swapPhyPage * PageSize]),
-                            PageSize,
-                            swapVirtPage * PageSize + sizeof(NoffHeader));
-                #ifdef USE_TLB
-                kernel->machine->tlbManager->invalidEntry(swapVirtPage, swapThreadId);
-                #endif
+                slot = oldSlot;
             }
+        }
+        if (region == NULL && slot == -1)
+        {
+            slot = swapManager->allocSlot();
+            ASSERT(slot != -1);     //交换区已满
+
+            ListIterator<PhyMemMapping*> slotIter(phyMemManager->getMappings(phyPage));
+            for (bool first = TRUE; !slotIter.IsDone(); slotIter.Next(), first = FALSE)
+            {
+                AddrSpace* space = slotIter.Item()->space;
+                int oldSlot = space->getSwapSlot(slotIter.Item()->virtualPage);
+
+                if (oldSlot != -1)
+                {
+                    swapManager->freeSlot(oldSlot);
+                }
+                if (!first)
+                {
+                    swapManager->shareSlot(slot);
+                }
+                space->setSwapSlot(slotIter.Item()->virtualPage, slot);
+            }
+        }
+    }
+
+    globalStats->evictions++;
+    if (region != NULL || dirty)
+    {
+        space->getMemoryStats()->dirtyWritebacks++;
+        globalStats->dirtyWritebacks++;
+    }
+
+    //写磁盘之前就解除映射：阻塞期间映射者退出时不会释放这个页框
+    phyMemManager->clearMappings(phyPage);
+
+    if (region != NULL)
+    {
+        region->getFile()->WriteAt(&(kernel->machine->mainMemory[phyPage * PageSize]),
+                                   region->getPageLength(regionPage),
+                                   region->getFilePosition(regionPage));
+    }
+    else if (dirty)
+    {
+        swapManager->writePage(slot, &(kernel->machine->mainMemory[phyPage * PageSize]));
+    }
+}
+
+/**
+ * @description: 把文件filename从offset开始的length字节映射到当前进程的地址空间，页在第一次访问时才读入
+ * @param {char* filename, int offset, int length} 超出文件末尾的部分被截掉
+ * @return: 映射区域的起始虚拟地址，失败返回-1
+ */
+int
+MemoryManager::mapFile(char* filename, int offset, int length)
+{
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(kernel->currentThread->getPid());
+    if (space == NULL || offset < 0 || length <= 0)
+    {
+        return -1;
+    }
+
+    OpenFile* file = kernel->fileSystem->Open(filename);
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    int fileLength = file->Length();
+    MappedRegion* region = NULL;
+    if (offset < fileLength)
+    {
+        region = space->addMappedRegion(file, offset, min(length, fileLength - offset));
+    }
+    if (region == NULL)
+    {
+        delete file;
+        return -1;
+    }
+
+    DEBUG(dbgAddr, "Mmap " << filename << " at page " << region->getStartPage() << ", " << region->getNumPages() << " pages");
+    return region->getStartPage() * PageSize;
+}
+
+/**
+ * @description: 解除从addr开始的Mmap映射，脏页写回文件
+ * @param {int addr} 必须是Mmap返回的地址
+ * @return: 没有这样的映射时返回FALSE
+ */
+bool
+MemoryManager::unmapFile(int addr)
+{
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(kernel->currentThread->getPid());
+    if (space == NULL || addr < 0 || addr % PageSize != 0)
+    {
+        return FALSE;
+    }
+
+    MappedRegion* region = space->findMappedRegion(addr / PageSize);
+    if (region == NULL || region->getStartPage() != addr / PageSize || region->getSegment() != NULL)
+    {
+        return FALSE;
+    }
+
+    pageLock->Acquire();
+    releaseMappedRegion(space, region);
+    pageLock->Release();
+
+    return TRUE;
+}
+
+/**
+ * @description: 把当前进程的堆顶移动increment字节。新增的页在第一次访问时才分配并填零，
+ *               堆缩小时释放不再属于堆的页
+ * @param {int increment} 
+ * @return: 原来的堆顶地址，失败返回-1
+ */
+int
+MemoryManager::sbrk(int increment)
+{
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(kernel->currentThread->getPid());
+    if (space == NULL)
+    {
+        return -1;
+    }
+
+    int oldBreak = space->getBreak();
+    int oldPages = space->getNumPages();
+    if (!space->setBreak(oldBreak + increment))
+    {
+        return -1;
+    }
+
+    if (space->getNumPages() < oldPages)
+    {
+        pageLock->Acquire();
+        for (int vpn = space->getNumPages(); vpn < oldPages; vpn++)
+        {
+            virtMemManager->releasePage(space, vpn);
+        }
+        pageLock->Release();
+    }
+
+    DEBUG(dbgAddr, "Sbrk " << increment << ": break " << oldBreak << " -> " << space->getBreak());
+    return oldBreak;
+}
+
+/**
+ * @description: 新建一个size字节的共享内存段并挂接到当前进程的地址空间
+ * @param {char* name, int size} 
+ * @return: 段的起始虚拟地址，同名的段已经存在时返回-1
+ */
+int
+MemoryManager::createSharedMemory(char* name, int size)
+{
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(kernel->currentThread->getPid());
+    if (space == NULL || size <= 0)
+    {
+        return -1;
+    }
+
+    SharedSegment* segment = virtMemManager->createSharedMemory(name, divRoundUp(size, PageSize));
+    if (segment == NULL)
+    {
+        return -1;
+    }
+
+    int addr = attachSegment(space, segment);
+    if (addr == -1)                     //地址空间已满，删除刚建立的段
+    {
+        segment->attach();
+        virtMemManager->detachSharedMemory(segment);
+    }
+    return addr;
+}
+
+/**
+ * @description: 把名为name的共享内存段挂接到当前进程的地址空间，页在第一次访问时才映射
+ * @param {char* name} 
+ * @return: 段的起始虚拟地址，段不存在时返回-1
+ */
+int
+MemoryManager::attachSharedMemory(char* name)
+{
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(kernel->currentThread->getPid());
+    SharedSegment* segment = virtMemManager->findSharedMemory(name);
+    if (space == NULL || segment == NULL)
+    {
+        return -1;
+    }
+
+    return attachSegment(space, segment);
+}
+
+/**
+ * @description: 解除从addr开始的共享内存段的挂接，最后一个挂接者离开时段被删除
+ * @param {int addr} 必须是ShmCreate或者ShmAttach返回的地址
+ * @return: 没有这样的挂接时返回FALSE
+ */
+bool
+MemoryManager::detachSharedMemory(int addr)
+{
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(kernel->currentThread->getPid());
+    if (space == NULL || addr < 0 || addr % PageSize != 0)
+    {
+        return FALSE;
+    }
+
+    MappedRegion* region = space->findMappedRegion(addr / PageSize);
+    if (region == NULL || region->getStartPage() != addr / PageSize || region->getSegment() == NULL)
+    {
+        return FALSE;
+    }
+
+    pageLock->Acquire();
+    releaseMappedRegion(space, region);
+    pageLock->Release();
+
+    return TRUE;
+}
+
+int
+MemoryManager::attachSegment(AddrSpace* space, SharedSegment* segment)
+{
+    MappedRegion* region = space->addSharedRegion(segment);
+    if (region == NULL)
+    {
+        return -1;
+    }
+
+    segment->attach();
+    DEBUG(dbgAddr, "Attach shared memory " << segment->getName() << " at page " << region->getStartPage());
+    return region->getStartPage() * PageSize;
+}
 
-            swapPageTable[swapVirtPage].valid = FALSE;
+/**
+ * @description: 释放Mmap区域占用的物理页框，脏页写回文件，然后删除该区域。
+ *               共享内存段的页框只有在没有其它映射者时才释放，段还有其它挂接者时先把页保存到段的交换槽。
+ *               调用者需要持有pageLock
+ * @param {AddrSpace* space, MappedRegion* region} 
+ * @return: 
+ */
+void
+MemoryManager::releaseMappedRegion(AddrSpace* space, MappedRegion* region)
+{
+    PageTable* pageTable = space->getPageTable();
+    int threadId = space->getThreadId();
+
+    for (int vpn = region->getStartPage(); vpn < region->getStartPage() + region->getNumPages(); vpn++)
+    {
+        TranslationEntry* entry = pageTable->lookup(vpn);
+        if (entry == NULL)
+        {
+            continue;
         }
 
-        phyMemManager->setVirtualPage(swapPhyPage, vpn);
-        phyMemManager->setMainThreadId(swapPhyPage, currentThreadId);
-        phyMemManager->updatePageWeight(swapPhyPage);
+        if (entry->isValid())
+        {
+            //先让TLB项失效，把写命中的脏位写回页表项
+            #ifdef USE_TLB
+            kernel->machine->tlbManager->invalidEntry(threadId, vpn);
+            #endif
+            SharedSegment* segment = region->getSegment();
+            if (segment != NULL)
+            {
+                int phyPage = entry->getPhysicalPage();
+                if (phyMemManager->getRefCount(phyPage) == 1 && segment->getAttachCnt() > 1)
+                {
+                    int segmentPage = vpn - region->getStartPage();
+                    int slot = segment->getSwapSlot(segmentPage);
+                    if (slot == -1)
+                    {
+                        slot = swapManager->allocSlot();
+                        ASSERT(slot != -1);     //交换区已满
+                        segment->setSwapSlot(segmentPage, slot);
+                    }
+                    swapManager->writePage(slot, &(kernel->machine->mainMemory[phyPage * PageSize]));
+                    space->getMemoryStats()->dirtyWritebacks++;
+                    globalStats->dirtyWritebacks++;
+                }
+            }
+            else if (entry->isDirty())
+            {
+                region->getFile()->WriteAt(&(kernel->machine->mainMemory[entry->getPhysicalPage() * PageSize]),
+                                           region->getPageLength(vpn),
+                                           region->getFilePosition(vpn));
+                space->getMemoryStats()->dirtyWritebacks++;
+                globalStats->dirtyWritebacks++;
+            }
+            phyMemManager->removeMapping(entry->getPhysicalPage(), space, vpn);
+            entry->setValid(FALSE);
+        }
+        pageTable->releaseEntry(vpn);
+    }
 
-        currentPageTable[vpn].valid = TRUE;
-        currentPageTable[vpn].physicalPage = swapPhyPage;
+    if (region->getSegment() != NULL)
+    {
+        virtMemManager->detachSharedMemory(region->getSegment());
+    }
+    space->removeMappedRegion(region);
+    delete region;
+}
 
-        //从磁盘上把该页读入内存
-        OpenFile* executable = kernel->currentThread->space->getExeFileId();
-        executable->ReadAt(&(kernel->machine->mainMemory[swapPhyPage * PageSize]),
-						    PageSize,
-							vpn * PageSize + sizeof(NoffHeader));
+/**
+ * @description: 查询一个虚存统计量，供MemStat系统调用使用
+ * @param {int threadId, int which} threadId为-1时查询全局统计，which是syscall.h中的MEMSTAT_*
+ * @return: 没有这个地址空间或者统计量时返回-1
+ */
+int
+MemoryManager::getMemoryStat(int threadId, int which)
+{
+    if (threadId == -1)
+    {
+        globalStats->residentPages = NumPhysPages - phyMemManager->getFrameAllocator()->getFreeNums();
+        return globalStats->getCounter(which);
     }
-    
-}
\ No newline at end of file
+
+    AddrSpace* space = virtMemManager->getAddrSpaceOfThread(threadId);
+    if (space == NULL)
+    {
+        return -1;
+    }
+    return space->getMemoryStats()->getCounter(which);
+}
+
+/**
+ * @description: 停机时打印全局统计、伙伴系统的空闲块和碎片统计、压缩页缓存的命中统计、缺页服务时间直方图，以及每个进程(包括已经退出的)的统计
+ * @param none
+ * @return:
+ */
+void
+MemoryManager::Print()
+{
+    globalStats->residentPages = NumPhysPages - phyMemManager->getFrameAllocator()->getFreeNums();
+    printf("Memory: frames in use %d of %d, faults major %d minor %d, evictions %d, dirty write-backs %d, swap-ins %d, zero-fills %d\n",
+           globalStats->residentPages, NumPhysPages, globalStats->majorFaults, globalStats->minorFaults,
+           globalStats->evictions, globalStats->dirtyWritebacks, globalStats->swapIns, globalStats->zeroFills);
+    phyMemManager->getFrameAllocator()->Print();
+    if (swapManager->getSwapCache() != NULL)
+    {
+        swapManager->getSwapCache()->Print();
+    }
+    globalStats->PrintFaultTimes();
+
+    ListIterator<MemoryStats*> iter(exitedStats);
+    for (; !iter.IsDone(); iter.Next())
+    {
+        iter.Item()->Print();
+    }
+    for (int i = 0; i < virtMemManager->getMaxThreadId(); i++)
+    {
+        AddrSpace* space = virtMemManager->getAddrSpaceOfThread(i);
+        if (space != NULL)
+        {
+            space->getMemoryStats()->Print();
+        }
+    }
+}
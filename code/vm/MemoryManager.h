@@ -2,7 +2,7 @@
  * @Author: Lollipop
  * @Date: 2019-11-12 11:22:38
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 12:01:13
+ * @LastEditTime: 2019-11-16 17:02:44
  * @Description: 
  */
 #ifndef MEMORYMANAGER_H
@@ -10,6 +10,10 @@
 
 #include "VirtMemManager.h"
 #include "PhyMemManager.h"
+#include "SwapManager.h"
+#include "MemoryStats.h"
+
+class Lock;
 
 class MemoryManager
 {
@@ -17,19 +21,43 @@ class MemoryManager
         MemoryManager();
         ~MemoryManager();
 
-        void pageFaultHandler(int vpn);
+        bool pageFaultHandler(int vpn);
+        bool readOnlyFaultHandler(int vpn);
 
         AddrSpace* getAddrSpaceOfThread(int threadId);
         AddrSpace* createAddrSpace(int threadId, char* filename);
-        //TODO:shareSpace()
+        AddrSpace* forkAddrSpace(int parentThreadId, int childThreadId);
         void deleteAddrSpace(int threadId);
 
+        int mapFile(char* filename, int offset, int length);
+        bool unmapFile(int addr);
+
+        int sbrk(int increment);
+
+        int createSharedMemory(char* name, int size);
+        int attachSharedMemory(char* name);
+        bool detachSharedMemory(int addr);
+
+        int getMemoryStat(int threadId, int which);     //threadId为-1时返回全局统计
+        void Print();
+
         VirtMemManager* getVirtMemManger() {return virtMemManager;}
         PhyMemManager* getPhyMemManager() {return phyMemManager;}
+        SwapManager* getSwapManager() {return swapManager;}
 
     private:
         VirtMemManager* virtMemManager;
         PhyMemManager* phyMemManager;
+        SwapManager* swapManager;
+        Lock* pageLock;                 //换入换出时会阻塞在磁盘上，缺页处理需要互斥
+        MemoryStats* globalStats;
+        List<MemoryStats*>* exitedStats;    //已经退出的进程的统计，停机时一起打印
+
+        int allocOnePage();
+        void swapOutPage(int phyPage);
+        bool loadPage(AddrSpace* space, int vpn, int phyPage);
+        void releaseMappedRegion(AddrSpace* space, MappedRegion* region);
+        int attachSegment(AddrSpace* space, SharedSegment* segment);
 };
 
 #endif// MEMORYMANAGER_H
\ No newline at end of file
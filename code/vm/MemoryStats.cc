@@ -0,0 +1,100 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-22 16:20:08
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-22 20:12:47
+ * @Description:
+ */
+#include "MemoryStats.h"
+#include "syscall.h"
+#include "debug.h"
+
+MemoryStats::MemoryStats(int threadId, char* fileName)
+{
+    this->threadId = threadId;
+    strncpy(name, fileName != NULL ? fileName : "", MemoryStatsNameLength - 1);
+    name[MemoryStatsNameLength - 1] = '\0';
+
+    residentPages = 0;
+    majorFaults = minorFaults = 0;
+    evictions = dirtyWritebacks = swapIns = zeroFills = 0;
+    for (int i = 0; i < FaultTimeBuckets; i++)
+    {
+        faultTicks[i] = 0;
+    }
+}
+
+/**
+ * @description: 记录一次缺页及其服务时间
+ * @param {bool major, int ticks} ticks是从进入缺页处理到页表项生效经过的模拟时间
+ * @return:
+ */
+void
+MemoryStats::recordFault(bool major, int ticks)
+{
+    int bucket = 0;
+
+    if (major)
+    {
+        majorFaults++;
+    }
+    else
+    {
+        minorFaults++;
+    }
+
+    while (bucket < FaultTimeBuckets - 1 && ticks >= (16 << bucket))
+    {
+        bucket++;
+    }
+    faultTicks[bucket]++;
+}
+
+int
+MemoryStats::getCounter(int which)
+{
+    switch (which)
+    {
+        case MEMSTAT_RESIDENT:      return residentPages;
+        case MEMSTAT_MAJOR_FAULTS:  return majorFaults;
+        case MEMSTAT_MINOR_FAULTS:  return minorFaults;
+        case MEMSTAT_EVICTIONS:     return evictions;
+        case MEMSTAT_WRITEBACKS:    return dirtyWritebacks;
+        case MEMSTAT_SWAP_INS:      return swapIns;
+        case MEMSTAT_ZERO_FILLS:    return zeroFills;
+        default:                    return -1;
+    }
+}
+
+void
+MemoryStats::Print()
+{
+    printf("%4d %-16s resident %d, faults major %d minor %d, evicted %d, written back %d, swapped in %d, zero-filled %d\n",
+           threadId, name, residentPages, majorFaults, minorFaults, evictions, dirtyWritebacks, swapIns, zeroFills);
+}
+
+void
+MemoryStats::PrintFaultTimes()
+{
+    printf("Fault service time (ticks):");
+    for (int i = 0; i < FaultTimeBuckets; i++)
+    {
+        if (faultTicks[i] == 0)
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            printf(" <16: %d", faultTicks[i]);
+        }
+        else if (i == FaultTimeBuckets - 1)
+        {
+            printf(" >=%d: %d", 8 << i, faultTicks[i]);
+        }
+        else
+        {
+            printf(" %d-%d: %d", 8 << i, (16 << i) - 1, faultTicks[i]);
+        }
+    }
+    printf("\n");
+}
@@ -0,0 +1,40 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-22 16:05:31
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-22 20:12:47
+ * @Description: 虚存统计。每个地址空间一份，记录驻留页数、主/次缺页、被换出的页、写回的脏页和换入的页；
+ *               MemoryManager另有一份全局的，额外记录缺页服务时间的直方图。
+ *               主缺页需要读磁盘(交换区、可执行文件或映射的文件)，次缺页不需要：填零、映射已在内存中的共享页、
+ *               从压缩缓存换入、写时复制
+ */
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#define FaultTimeBuckets 12             //第0个桶是不到16个tick的缺页，第i个桶是[2^(i+3), 2^(i+4))，最后一个桶不设上限
+#define MemoryStatsNameLength 32
+
+class MemoryStats
+{
+    public:
+        MemoryStats(int threadId, char* fileName);
+
+        int threadId;
+        char name[MemoryStatsNameLength];   //可执行文件名，太长时截断
+
+        int residentPages;              //当前映射的页数(全局统计中是已分配的页框数)
+        int majorFaults;
+        int minorFaults;
+        int evictions;                  //被换出的页
+        int dirtyWritebacks;            //换出或者解除映射时写回交换区或文件的脏页
+        int swapIns;                    //从交换区读入的页，包括压缩缓存命中
+        int zeroFills;                  //第一次访问时填零的页
+        int faultTicks[FaultTimeBuckets];   //缺页服务时间的直方图
+
+        void recordFault(bool major, int ticks);
+        int getCounter(int which);      //which是syscall.h中的MEMSTAT_*，不存在时返回-1
+        void Print();
+        void PrintFaultTimes();
+};
+
+#endif	// MEMORYSTATS_H
@@ -2,23 +2,44 @@
  * @Author: Lollipop
  * @Date: 2019-11-11 22:12:35
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-12 11:29:52
+ * @LastEditTime: 2019-11-16 16:08:37
  * @Description: 
  */
 #include "PhyMemManager.h"
 #include "SwappingLRU.h"
+#include "addrspace.h"
+#include "debug.h"
 
 PhyMemManager::PhyMemManager(int pageNums)
 {
     phyPageNums = pageNums;
-    phyMemoryMap = new Bitmap(pageNums);
+    frameAllocator = new BuddyAllocator(pageNums);
     phyMemPageTable = new PhyMemPageEntry[pageNums];
     swappingStrategy = new SwappingLRU(pageNums);
+
+    for (int i = 0; i < pageNums; i++)
+    {
+        phyMemPageTable[i].refCount = 0;
+        phyMemPageTable[i].mappings = new List<PhyMemMapping*>();
+        phyMemPageTable[i].segment = NULL;
+        phyMemPageTable[i].segmentPage = -1;
+        phyMemPageTable[i].pinned = FALSE;
+    }
 }
 
 PhyMemManager::~PhyMemManager()
 {
-    delete phyMemoryMap;
+    //地址空间和共享段可能已经被删除，只释放映射记录本身
+    for (int i = 0; i < phyPageNums; i++)
+    {
+        while (!phyMemPageTable[i].mappings->IsEmpty())
+        {
+            delete phyMemPageTable[i].mappings->RemoveFront();
+        }
+        delete phyMemPageTable[i].mappings;
+    }
+
+    delete frameAllocator;
     delete [] phyMemPageTable;
     delete swappingStrategy;
 }
@@ -26,11 +47,42 @@ PhyMemManager::~PhyMemManager()
 int
 PhyMemManager::findOneEmptyPage()
 {
-    int page;
+    return frameAllocator->alloc(0);
+}
 
-    page = phyMemoryMap->FindAndSet();
+/**
+ * @description: 分配2^order个物理地址连续、按块大小对齐的页框，供内核使用(例如大块缓冲区、连续的磁盘传输)。
+ *               这些页框没有映射者，不会被换出，直到调用freeContiguousPages
+ * @param {int order} 
+ * @return: 第一个页框号，没有足够大的连续空闲块时返回-1
+ */
+int
+PhyMemManager::allocContiguousPages(int order)
+{
+    int first = frameAllocator->alloc(order);
+
+    if (first != -1)
+    {
+        for (int i = first; i < first + (1 << order); i++)
+        {
+            phyMemPageTable[i].pinned = TRUE;
+            swappingStrategy->pinElement(i);
+        }
+        DEBUG(dbgAddr, "Allocate contiguous frames " << first << " - " << first + (1 << order) - 1);
+    }
+    return first;
+}
 
-    return page;
+void
+PhyMemManager::freeContiguousPages(int firstPage, int order)
+{
+    for (int i = firstPage; i < firstPage + (1 << order); i++)
+    {
+        ASSERT(phyMemPageTable[i].pinned);
+        phyMemPageTable[i].pinned = FALSE;
+        swappingStrategy->unpinElement(i);
+    }
+    frameAllocator->free(firstPage);
 }
 
 /**
@@ -42,71 +94,179 @@ PhyMemManager::findOneEmptyPage()
 int
 PhyMemManager::swapOnePage()
 {
-    return swappingStrategy->findOneElementToSwap();
+    int phyPage = swappingStrategy->findOneElementToSwap();
+
+    ASSERT(!phyMemPageTable[phyPage].pinned);   //所有页框都被内核占用
+    return phyPage;
 }
 
+/**
+ * @description: 释放一个物理页框，同时清除它的反向映射
+ * @param {int phyPage} 
+ * @return: 
+ */
 void
 PhyMemManager::clearOnePage(int phyPage)
 {
-    phyMemoryMap->Clear(phyPage);
+    clearMappings(phyPage);
+    frameAllocator->free(phyPage);
 }
 
 bool
 PhyMemManager::isPageValid(int phyPage)
 {
-    return phyMemoryMap->Test(phyPage);
+    return frameAllocator->isAllocated(phyPage);
 }
 
-int 
-PhyMemManager::getMainThread(int phyPage)
+/**
+ * @description: 记录一个新的(地址空间, 逻辑页号)映射到该物理页框，引用计数加一
+ * @param {int phyPage, AddrSpace* space, int virtualPage, TranslationEntry* entry} entry是space页表中virtualPage的表项
+ * @return: 
+ */
+void
+PhyMemManager::addMapping(int phyPage, AddrSpace* space, int virtualPage, TranslationEntry* entry)
 {
-    if (phyMemoryMap->Test(phyPage))
+    if (frameAllocator->isAllocated(phyPage))
     {
-        return phyMemPageTable[phyPage].mainThreadId;
+        PhyMemMapping* mapping = new PhyMemMapping;
+        mapping->space = space;
+        mapping->virtualPage = virtualPage;
+        mapping->entry = entry;
+
+        phyMemPageTable[phyPage].mappings->Append(mapping);
+        phyMemPageTable[phyPage].refCount++;
+        space->getMemoryStats()->residentPages++;
     }
-    else
+}
+
+/**
+ * @description: 删除一个映射，引用计数减一。引用计数为0时物理页框被释放。
+ * @param {int phyPage, AddrSpace* space, int virtualPage} 
+ * @return: 剩余的引用计数
+ */
+int
+PhyMemManager::removeMapping(int phyPage, AddrSpace* space, int virtualPage)
+{
+    if (!frameAllocator->isAllocated(phyPage))
     {
-        return -1;
+        return 0;
     }
+
+    PhyMemPageEntry* entry = &phyMemPageTable[phyPage];
+    ListIterator<PhyMemMapping*> iter(entry->mappings);
+    PhyMemMapping* target = NULL;
+
+    for (; !iter.IsDone(); iter.Next())
+    {
+        if (iter.Item()->space == space && iter.Item()->virtualPage == virtualPage)
+        {
+            target = iter.Item();
+            break;
+        }
+    }
+
+    if (target != NULL)
+    {
+        entry->mappings->Remove(target);
+        delete target;
+        entry->refCount--;
+        space->getMemoryStats()->residentPages--;
+    }
+
+    if (entry->refCount == 0)
+    {
+        clearOnePage(phyPage);
+    }
+
+    return entry->refCount;
 }
 
+/**
+ * @description: 清空该物理页框的所有映射(页框被换出或释放时调用)，但不修改位图
+ * @param {int phyPage} 
+ * @return: 
+ */
 void
-PhyMemManager::setMainThreadId(int phyPage, int threadId)
+PhyMemManager::clearMappings(int phyPage)
 {
-    if (phyMemoryMap->Test(phyPage))
+    PhyMemPageEntry* entry = &phyMemPageTable[phyPage];
+
+    while (!entry->mappings->IsEmpty())
+    {
+        PhyMemMapping* mapping = entry->mappings->RemoveFront();
+        mapping->space->getMemoryStats()->residentPages--;
+        delete mapping;
+    }
+    entry->refCount = 0;
+
+    if (entry->segment != NULL)
     {
-        phyMemPageTable[phyPage].mainThreadId = threadId;
+        entry->segment->setFrame(entry->segmentPage, -1);
+        entry->segment = NULL;
+        entry->segmentPage = -1;
     }
 }
 
 int
-PhyMemManager::getVirtualPage(int phyPage)
+PhyMemManager::getRefCount(int phyPage)
 {
-    if (phyMemoryMap->Test(phyPage))
+    if (frameAllocator->isAllocated(phyPage))
     {
-        return phyMemPageTable[phyPage].virtualPage;
+        return phyMemPageTable[phyPage].refCount;
     }
     else
     {
-        return -1;
+        return 0;
     }
-    
-    
+}
+
+List<PhyMemMapping*>*
+PhyMemManager::getMappings(int phyPage)
+{
+    return phyMemPageTable[phyPage].mappings;
 }
 
 void
-PhyMemManager::setVirtualPage(int phyPage, int virtualPage)
+PhyMemManager::setSharedSegment(int phyPage, SharedSegment* segment, int segmentPage)
 {
-    if (phyMemoryMap->Test(phyPage))
+    if (frameAllocator->isAllocated(phyPage))
     {
-        phyMemPageTable[phyPage].virtualPage = virtualPage;
+        phyMemPageTable[phyPage].segment = segment;
+        phyMemPageTable[phyPage].segmentPage = segmentPage;
+        segment->setFrame(segmentPage, phyPage);
+    }
+}
+
+SharedSegment*
+PhyMemManager::getSharedSegment(int phyPage)
+{
+    if (frameAllocator->isAllocated(phyPage))
+    {
+        return phyMemPageTable[phyPage].segment;
+    }
+    else
+    {
+        return NULL;
+    }
+}
+
+int
+PhyMemManager::getSegmentPage(int phyPage)
+{
+    if (frameAllocator->isAllocated(phyPage))
+    {
+        return phyMemPageTable[phyPage].segmentPage;
+    }
+    else
+    {
+        return -1;
     }
 }
 
 void
 PhyMemManager::updatePageWeight(int phyPage)
 {
-    if (phyMemoryMap->Test(phyPage))
+    if (frameAllocator->isAllocated(phyPage))
     {
         swappingStrategy->updateElementWeight(phyPage);
     }
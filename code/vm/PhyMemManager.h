@@ -2,22 +2,40 @@
  * @Author: Lollipop
  * @Date: 2019-11-11 20:45:25
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-12 11:29:12
- * @Description: 用于管理物理内存的数据结构。使用位图记录物理页框的分配情况。
- *               使用PhyMemPageEntry记录物理页框所属的线程和对应的逻辑页号。(感觉这里相当于实现了倒排页表？)
+ * @LastEditTime: 2019-11-16 15:52:10
+ * @Description: 用于管理物理内存的数据结构。使用伙伴系统(BuddyAllocator)分配物理页框。
+ *               使用PhyMemPageEntry记录映射了该物理页框的所有(地址空间, 逻辑页号, 页表项)以及引用计数。(感觉这里相当于实现了倒排页表？)
+ *               共享代码页会被多个地址空间同时映射，换出时需要通过反向映射使所有映射者的页表项失效。
+ *               内核可以用allocContiguousPages分配物理地址连续、对齐的多个页框，这些页框被固定，不会被换出。
  */
 
 #ifndef PHYMEMMANAGER_H
 #define PHYMEMMANAGER_H
 
-#include "bitmap.h"
+#include "BuddyAllocator.h"
+#include "list.h"
 #include "SwappingStrategy.h"
+#include "SharedSegment.h"
+#include "translate.h"
 
-class PhyMemPageEntry
+class AddrSpace;
+
+class PhyMemMapping
 {
     public:
-        int mainThreadId;
+        AddrSpace* space;                   //映射者的地址空间
         int virtualPage;
+        TranslationEntry* entry;            //映射者页表中的表项，换出时不需要再查找页表
+};
+
+class PhyMemPageEntry
+{
+    public:
+        int refCount;                       //映射了该页框的页表项数量
+        List<PhyMemMapping*>* mappings;     //反向映射：所有映射了该页框的(地址空间, 逻辑页号)
+        SharedSegment* segment;             //该页框属于哪个共享段，私有页为NULL
+        int segmentPage;                    //在共享段中的页号
+        bool pinned;                        //由allocContiguousPages分配给内核，不能被换出
 };
 
 class PhyMemManager
@@ -27,19 +45,29 @@ class PhyMemManager
         ~PhyMemManager();
 
         int findOneEmptyPage();
+        int allocContiguousPages(int order);
+        void freeContiguousPages(int firstPage, int order);
         int swapOnePage();
         void clearOnePage(int phyPage);
         bool isPageValid(int phyPage);
 
-        int getMainThread(int phyPage);
-        void setMainThreadId(int phyPage, int threadId);
-        int getVirtualPage(int phyPage);
-        void setVirtualPage(int phyPage, int virtualPage);
+        void addMapping(int phyPage, AddrSpace* space, int virtualPage, TranslationEntry* entry);
+        int removeMapping(int phyPage, AddrSpace* space, int virtualPage);
+        void clearMappings(int phyPage);
+        int getRefCount(int phyPage);
+        List<PhyMemMapping*>* getMappings(int phyPage);
+
+        void setSharedSegment(int phyPage, SharedSegment* segment, int segmentPage);
+        SharedSegment* getSharedSegment(int phyPage);
+        int getSegmentPage(int phyPage);
+
         void updatePageWeight(int phyPage);
 
+        BuddyAllocator* getFrameAllocator() {return frameAllocator;}
+
     private:
         int phyPageNums;
-        Bitmap* phyMemoryMap;
+        BuddyAllocator* frameAllocator;
         PhyMemPageEntry* phyMemPageTable;
         SwappingStrategy* swappingStrategy;
 };
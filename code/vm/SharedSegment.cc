@@ -0,0 +1,87 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-16 10:20:41
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-16 15:40:22
+ * @Description:
+ */
+#include "SharedSegment.h"
+#include "main.h"
+
+SharedSegment::SharedSegment(char* segmentName, int pageNums)
+{
+    ASSERT(pageNums >= 0);
+
+    name = new char[strlen(segmentName) + 1];
+    strcpy(name, segmentName);
+    numPages = pageNums;
+    attachCnt = 0;
+
+    frameTable = new int[pageNums];
+    swapSlotTable = new int[pageNums];
+    for (int i = 0; i < pageNums; i++)
+    {
+        frameTable[i] = -1;
+        swapSlotTable[i] = -1;
+    }
+}
+
+SharedSegment::~SharedSegment()
+{
+    delete[] name;
+    delete[] frameTable;
+    delete[] swapSlotTable;
+}
+
+int
+SharedSegment::getFrame(int page)
+{
+    if (page >= 0 && page < numPages)
+    {
+        return frameTable[page];
+    }
+    else
+    {
+        return -1;
+    }
+}
+
+void
+SharedSegment::setFrame(int page, int phyPage)
+{
+    if (page >= 0 && page < numPages)
+    {
+        frameTable[page] = phyPage;
+    }
+}
+
+int
+SharedSegment::getSwapSlot(int page)
+{
+    if (page >= 0 && page < numPages)
+    {
+        return swapSlotTable[page];
+    }
+    else
+    {
+        return -1;
+    }
+}
+
+void
+SharedSegment::setSwapSlot(int page, int slot)
+{
+    if (page >= 0 && page < numPages)
+    {
+        swapSlotTable[page] = slot;
+    }
+}
+
+int
+SharedSegment::detach()
+{
+    ASSERT(attachCnt > 0);
+
+    attachCnt--;
+    return attachCnt;
+}
@@ -0,0 +1,40 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-16 10:12:05
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-16 15:40:22
+ * @Description: 共享段。记录一组可以被多个地址空间同时映射的虚拟页，以及每一页当前所在的物理页框。
+ *               同一个可执行文件的代码段就是一个以文件名命名的共享段。
+ *               ShmCreate创建的共享内存段也是一个共享段，它的页被换出时保存在段自己的交换槽中
+ */
+#ifndef SHAREDSEGMENT_H
+#define SHAREDSEGMENT_H
+
+class SharedSegment
+{
+    public:
+        SharedSegment(char* segmentName, int pageNums);
+        ~SharedSegment();
+
+        char* getName() {return name;}
+        int getNumPages() {return numPages;}
+
+        int getFrame(int page);
+        void setFrame(int page, int phyPage);
+
+        int getSwapSlot(int page);
+        void setSwapSlot(int page, int slot);
+
+        void attach() {attachCnt++;}
+        int detach();                   //返回剩余的映射者数量
+        int getAttachCnt() {return attachCnt;}
+
+    private:
+        char* name;
+        int numPages;
+        int* frameTable;                //每一页所在的物理页框，不在内存中为-1
+        int* swapSlotTable;             //共享内存段被换出的页所在的交换槽，代码段不使用
+        int attachCnt;                  //映射了该段的地址空间数量
+};
+
+#endif	// SHAREDSEGMENT_H
@@ -0,0 +1,230 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-19 09:30:17
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-19 16:48:02
+ * @Description: 压缩格式：一串记录，控制字节最高位为0时后面跟着(低7位+1)个原样的字节；
+ *               最高位为1时表示一次匹配，长度为(低7位+3)，下一个字节是向前的距离
+ */
+#include "main.h"
+#include "SwapCache.h"
+
+#define MinMatchLength 3
+#define MaxMatchLength (0x7F + MinMatchLength)
+#define MaxLiteralRun 0x80
+
+/**
+ * @description: 贪心的LZ77压缩，页只有PageSize字节，直接向前穷举查找最长的匹配
+ * @param {char* from, char* to} to至少要有PageSize字节
+ * @return: 压缩后的字节数，压缩后不小于PageSize时返回-1
+ */
+static int
+compressPage(char* from, char* to)
+{
+    int in = 0, out = 0;
+    int literalStart = 0;
+
+    while (in < PageSize)
+    {
+        int bestLength = 0, bestDistance = 0;
+        int limit = min(MaxMatchLength, PageSize - in);
+
+        for (int j = max(0, in - 0xFF); j < in; j++)
+        {
+            int length = 0;
+            while (length < limit && from[j + length] == from[in + length])
+            {
+                length++;
+            }
+            if (length > bestLength)
+            {
+                bestLength = length;
+                bestDistance = in - j;
+            }
+        }
+
+        if (bestLength < MinMatchLength && in - literalStart < MaxLiteralRun)
+        {
+            in++;
+            continue;
+        }
+
+        //先输出前面积累的原样字节
+        int literals = in - literalStart;
+        if (literals > 0)
+        {
+            if (out + 1 + literals >= PageSize)
+            {
+                return -1;
+            }
+            to[out++] = (char)(literals - 1);
+            bcopy(from + literalStart, to + out, literals);
+            out += literals;
+        }
+
+        if (bestLength >= MinMatchLength)
+        {
+            if (out + 2 >= PageSize)
+            {
+                return -1;
+            }
+            to[out++] = (char)(0x80 | (bestLength - MinMatchLength));
+            to[out++] = (char)bestDistance;
+            in += bestLength;
+        }
+        literalStart = in;
+    }
+
+    int literals = in - literalStart;
+    if (literals > 0)
+    {
+        if (out + 1 + literals >= PageSize)
+        {
+            return -1;
+        }
+        to[out++] = (char)(literals - 1);
+        bcopy(from + literalStart, to + out, literals);
+        out += literals;
+    }
+    return out;
+}
+
+static void
+decompressPage(char* from, int size, char* to)
+{
+    int in = 0, out = 0;
+
+    while (in < size)
+    {
+        unsigned char control = (unsigned char)from[in++];
+
+        if (control & 0x80)
+        {
+            int length = (control & 0x7F) + MinMatchLength;
+            int distance = (unsigned char)from[in++];
+            for (int i = 0; i < length; i++, out++)
+            {
+                to[out] = to[out - distance];
+            }
+        }
+        else
+        {
+            int length = control + 1;
+            bcopy(from + in, to + out, length);
+            in += length;
+            out += length;
+        }
+    }
+    ASSERT(out == PageSize);
+}
+
+SwapCache::SwapCache(int slotNums, int poolSize)
+{
+    this->slotNums = slotNums;
+    this->poolSize = poolSize;
+    usedSize = 0;
+    hits = misses = writeBacks = 0;
+
+    slotTable = new SwapCacheEntry*[slotNums];
+    for (int i = 0; i < slotNums; i++)
+    {
+        slotTable[i] = NULL;
+    }
+    lruList = new List<SwapCacheEntry*>();
+}
+
+SwapCache::~SwapCache()
+{
+    while (!lruList->IsEmpty())
+    {
+        SwapCacheEntry* entry = lruList->RemoveFront();
+        delete[] entry->data;
+        delete entry;
+    }
+    delete lruList;
+    delete[] slotTable;
+}
+
+bool
+SwapCache::lookup(int slot, char* into)
+{
+    SwapCacheEntry* entry = slotTable[slot];
+
+    if (entry == NULL)
+    {
+        misses++;
+        return FALSE;
+    }
+
+    hits++;
+    decompressPage(entry->data, entry->size, into);
+    lruList->Remove(entry);
+    lruList->Append(entry);
+    return TRUE;
+}
+
+bool
+SwapCache::insert(int slot, char* from, bool dirty)
+{
+    char buffer[PageSize];
+    int size = compressPage(from, buffer);
+
+    remove(slot);
+    if (size == -1)
+    {
+        return FALSE;
+    }
+
+    SwapCacheEntry* entry = new SwapCacheEntry;
+    entry->slot = slot;
+    entry->size = size;
+    entry->dirty = dirty;
+    entry->data = new char[size];
+    bcopy(buffer, entry->data, size);
+
+    slotTable[slot] = entry;
+    lruList->Append(entry);
+    usedSize += size;
+    DEBUG(dbgAddr, "Swap cache: slot " << slot << " compressed to " << size << " bytes");
+    return TRUE;
+}
+
+void
+SwapCache::remove(int slot)
+{
+    SwapCacheEntry* entry = slotTable[slot];
+
+    if (entry != NULL)
+    {
+        lruList->Remove(entry);
+        slotTable[slot] = NULL;
+        usedSize -= entry->size;
+        delete[] entry->data;
+        delete entry;
+    }
+}
+
+int
+SwapCache::evictOne(char* into, bool* dirty)
+{
+    ASSERT(!lruList->IsEmpty());
+
+    SwapCacheEntry* entry = lruList->Front();
+    int slot = entry->slot;
+
+    *dirty = entry->dirty;
+    if (entry->dirty)
+    {
+        decompressPage(entry->data, entry->size, into);
+        writeBacks++;
+    }
+    remove(slot);
+    return slot;
+}
+
+void
+SwapCache::Print()
+{
+    printf("Swap cache: hits %d, misses %d, write backs %d, pool %d/%d bytes\n",
+            hits, misses, writeBacks, usedSize, poolSize);
+}
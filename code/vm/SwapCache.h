@@ -0,0 +1,54 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-19 09:12:40
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-19 16:48:02
+ * @Description: 交换区前面的压缩页缓存。换出的页用LZ77压缩后保存在一个固定大小的内存池里，
+ *               再次缺页时直接解压，不需要读磁盘；池满时按LRU淘汰，只有脏的缓存页才需要写回交换区。
+ *               从交换区读入的页也会缓存一份(干净的)，下次再被换出又换入时同样不用读磁盘
+ */
+#ifndef SWAPCACHE_H
+#define SWAPCACHE_H
+
+#include "list.h"
+#include "memory.h"
+
+#define SwapCachePoolSize (16 * PageSize)       //内存池的字节数，为0时不使用缓存
+
+class SwapCacheEntry
+{
+    public:
+        int slot;                   //交换槽号
+        int size;                   //压缩后的字节数
+        bool dirty;                 //交换区中的内容是旧的，淘汰时需要写回
+        char* data;
+};
+
+class SwapCache
+{
+    public:
+        SwapCache(int slotNums, int poolSize);
+        ~SwapCache();
+
+        bool lookup(int slot, char* into);                  //命中时解压到into
+        bool insert(int slot, char* from, bool dirty);      //页不可压缩时返回FALSE，此时缓存中不会有该槽
+        void remove(int slot);                              //交换槽被释放，缓存的内容直接丢弃
+
+        bool isOverflow() {return usedSize > poolSize;}
+        int evictOne(char* into, bool* dirty);              //淘汰最久没有使用的页，返回它的交换槽
+
+        void Print();
+
+    private:
+        int slotNums;
+        int poolSize;
+        int usedSize;
+        SwapCacheEntry** slotTable;             //交换槽到缓存项的索引
+        List<SwapCacheEntry*>* lruList;         //表头是最久没有使用的页
+
+        int hits;
+        int misses;
+        int writeBacks;
+};
+
+#endif	// SWAPCACHE_H
@@ -0,0 +1,152 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-17 09:52:33
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-17 15:12:08
+ * @Description:
+ */
+#include "SwapManager.h"
+#include "main.h"
+#include "synchdisk.h"
+
+SwapManager::SwapManager(int slotNums)
+{
+    ASSERT(slotNums > 0 && slotNums <= NumSectors);
+    ASSERT(PageSize == SectorSize);
+
+    this->slotNums = slotNums;
+    slotMap = new Bitmap(slotNums);
+    refCountTable = new int[slotNums];
+    for (int i = 0; i < slotNums; i++)
+    {
+        refCountTable[i] = 0;
+    }
+
+    swapCache = NULL;
+    if (SwapCachePoolSize > 0)
+    {
+        swapCache = new SwapCache(slotNums, SwapCachePoolSize);
+    }
+}
+
+SwapManager::~SwapManager()
+{
+    delete slotMap;
+    delete[] refCountTable;
+    delete swapCache;
+}
+
+int
+SwapManager::allocSlot()
+{
+    int slot = slotMap->FindAndSet();
+
+    if (slot != -1)
+    {
+        refCountTable[slot] = 1;
+    }
+    return slot;
+}
+
+void
+SwapManager::shareSlot(int slot)
+{
+    ASSERT(slot >= 0 && slot < slotNums && refCountTable[slot] > 0);
+
+    refCountTable[slot]++;
+}
+
+int
+SwapManager::freeSlot(int slot)
+{
+    ASSERT(slot >= 0 && slot < slotNums && refCountTable[slot] > 0);
+
+    refCountTable[slot]--;
+    if (refCountTable[slot] == 0)
+    {
+        slotMap->Clear(slot);
+        if (swapCache != NULL)
+        {
+            swapCache->remove(slot);
+        }
+    }
+    return refCountTable[slot];
+}
+
+int
+SwapManager::getRefCount(int slot)
+{
+    ASSERT(slot >= 0 && slot < slotNums);
+
+    return refCountTable[slot];
+}
+
+/**
+ * @description: 从交换槽读入一页。压缩缓存命中时不访问磁盘，否则从磁盘读入并在缓存中保存一份，
+ *               读磁盘会阻塞当前线程直到磁盘操作完成
+ * @param {int slot, char* into} 
+ * @return: 是否读了磁盘
+ */
+bool
+SwapManager::readPage(int slot, char* into)
+{
+    ASSERT(slot >= 0 && slot < slotNums);
+
+    if (swapCache != NULL && swapCache->lookup(slot, into))
+    {
+        DEBUG(dbgAddr, "Swap in from cache, slot " << slot);
+        return FALSE;
+    }
+
+    DEBUG(dbgAddr, "Swap in from slot " << slot);
+    kernel->synchDisk->ReadSector(SwapStartSector + slot, into);
+
+    if (swapCache != NULL && swapCache->insert(slot, into, FALSE))
+    {
+        flushSwapCache();
+    }
+    return TRUE;
+}
+
+/**
+ * @description: 把一页写入交换槽。可以压缩的页只写入缓存，缓存满时才把最久没有使用的脏页写回磁盘
+ * @param {int slot, char* from} 
+ * @return: 
+ */
+void
+SwapManager::writePage(int slot, char* from)
+{
+    ASSERT(slot >= 0 && slot < slotNums);
+
+    if (swapCache != NULL && swapCache->insert(slot, from, TRUE))
+    {
+        DEBUG(dbgAddr, "Swap out to cache, slot " << slot);
+        flushSwapCache();
+        return;
+    }
+
+    DEBUG(dbgAddr, "Swap out to slot " << slot);
+    kernel->synchDisk->WriteSector(SwapStartSector + slot, from);
+}
+
+/**
+ * @description: 缓存超过内存池大小时淘汰缓存页，脏页写回磁盘
+ * @param none 
+ * @return: 
+ */
+void
+SwapManager::flushSwapCache()
+{
+    char buffer[PageSize];
+    bool dirty;
+
+    while (swapCache->isOverflow())
+    {
+        int slot = swapCache->evictOne(buffer, &dirty);
+        if (dirty)
+        {
+            DEBUG(dbgAddr, "Swap cache write back, slot " << slot);
+            kernel->synchDisk->WriteSector(SwapStartSector + slot, buffer);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * @Author: Lollipop
+ * @Date: 2019-11-17 09:40:16
+ * @LastEditors: Lollipop
+ * @LastEditTime: 2019-11-17 15:12:08
+ * @Description: 交换区管理器。磁盘最后SwapSectors个扇区作为交换区，每个扇区存放一个页(PageSize == SectorSize)。
+ *               写时复制之后父子进程的同一个虚拟页可能共享同一个交换槽，因此每个交换槽带有引用计数。
+ *               读写交换槽时先经过压缩页缓存(见SwapCache.h)，只有缓存未命中或者缓存满时才访问磁盘
+ */
+#ifndef SWAPMANAGER_H
+#define SWAPMANAGER_H
+
+#include "bitmap.h"
+#include "disk.h"
+#include "SwapCache.h"
+
+#define SwapSectors 256
+#define SwapStartSector (NumSectors - SwapSectors)
+
+class SwapManager
+{
+    public:
+        SwapManager(int slotNums);
+        ~SwapManager();
+
+        int allocSlot();                        //分配一个交换槽，引用计数为1，交换区满时返回-1
+        void shareSlot(int slot);               //引用计数加1
+        int freeSlot(int slot);                 //引用计数减1，返回剩余的引用数量，为0时释放交换槽
+        int getRefCount(int slot);
+
+        bool readPage(int slot, char* into);    //压缩缓存命中时返回FALSE
+        void writePage(int slot, char* from);
+
+        SwapCache* getSwapCache() {return swapCache;}
+
+    private:
+        int slotNums;
+        Bitmap* slotMap;
+        int* refCountTable;
+        SwapCache* swapCache;
+
+        void flushSwapCache();
+};
+
+#endif	// SWAPMANAGER_H
@@ -48,4 +48,17 @@ void
 SwappingLRU::updateElementWeight(int index)
 {
     lastUsedTimeTable[index] = kernel->stats->totalTicks;
-}
\ No newline at end of file
+}
+
+//被固定的项的上次使用时间设为最大值，只有所有项都被固定时才会被选中
+void
+SwappingLRU::pinElement(int index)
+{
+    lastUsedTimeTable[index] = 0x7fffffff;
+}
+
+void
+SwappingLRU::unpinElement(int index)
+{
+    lastUsedTimeTable[index] = -1;
+}
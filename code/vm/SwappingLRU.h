@@ -21,6 +21,8 @@ public:
 
     virtual int findOneElementToSwap();
     virtual void updateElementWeight(int index);
+    virtual void pinElement(int index);
+    virtual void unpinElement(int index);
 };
 
 #endif	// SWAPPINGLRU_H
\ No newline at end of file
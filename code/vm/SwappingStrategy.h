@@ -13,6 +13,8 @@ class SwappingStrategy
     public:
         virtual int findOneElementToSwap() = 0;
         virtual void updateElementWeight(int index) = 0;
+        virtual void pinElement(int index) = 0;     //被固定的项不会被选中替换
+        virtual void unpinElement(int index) = 0;
 };
 
 #endif	// SWAPPINGSTRATEGY_H
\ No newline at end of file
@@ -2,8 +2,8 @@
  * @Author: Lollipop
  * @Date: 2019-11-12 10:44:37
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 12:07:45
- * @Description: 这里有一个问题：所有进程的虚拟页总和不能大于MAX_VIRT_PAGES，而且不同进程的虚拟地址大小不同
+ * @LastEditTime: 2019-11-29 14:05:18
+ * @Description: 每个地址空间有自己的多级页表，页表只在用到时分配，因此不再限制所有进程的虚拟页总数
  */
 #include "VirtMemManager.h"
 #include "main.h"
@@ -12,19 +12,25 @@ VirtMemManager::VirtMemManager(int size)
 {
     ASSERT(size > 0);
 
-    virtPageNums = 0;
-    virtMemTableSize = size;
+    virtMemTable = new PidTable<AddrSpace*>(size);
 
-    virtMemTable = new AddrSpace*[size];
-    for (int i = 0; i < size; i++)
-    {
-        virtMemTable[i] = NULL;
-    }
+    sharedTextList = new List<SharedSegment*>();
+    sharedMemList = new List<SharedSegment*>();
 }
 
 VirtMemManager::~VirtMemManager()
 {
-    delete[] virtMemTable;
+    while (!sharedTextList->IsEmpty())
+    {
+        delete sharedTextList->RemoveFront();
+    }
+    delete sharedTextList;
+    while (!sharedMemList->IsEmpty())
+    {
+        delete sharedMemList->RemoveFront();
+    }
+    delete sharedMemList;
+    delete virtMemTable;
 }
 
 AddrSpace*
@@ -32,7 +38,7 @@ VirtMemManager::createAddrSpace(int mainThreadId, char* filename)
 {
     AddrSpace* entry;
 
-    entry = virtMemTable[mainThreadId];
+    entry = virtMemTable->get(mainThreadId);
     if (entry != NULL)
     {
         return entry;
@@ -40,62 +46,262 @@ VirtMemManager::createAddrSpace(int mainThreadId, char* filename)
 
     entry = new AddrSpace(mainThreadId, filename);
 
-    int size = entry->getNumPages();
-    if (virtPageNums + size > MAX_VIRT_PAGES) //这里所有的进程共用一个虚拟地址空间？为什么要限制全局虚拟页的数量？而且各个进程的虚拟地址空间大小不相同
+    if (entry->getPageTable() == NULL)          //可执行文件打开失败
     {
         delete entry;
         entry = NULL;
     }
     else
     {
-        virtMemTable[mainThreadId] = entry;
-        virtPageNums += size;
+        virtMemTable->set(mainThreadId, entry);
+        entry->setSharedText(attachSharedText(entry->getFileName(), entry->getTextPageNums()));
     }
 
     return entry;
 }
 
 /**
- * @description: 遍历进程的页表，将该进程占用的物理页清空, 然后删除进程的地址空间
- * @param {int threadId} 
+ * @description: 以写时复制的方式复制父进程的地址空间。父子进程映射相同的物理页框，
+ *               非代码页在双方的页表中都被标记为只读，任何一方写入时在ReadOnlyException中复制该页
+ * @param {int parentThreadId, int childThreadId} 
+ * @return: 子进程的地址空间，失败返回NULL
+ */
+AddrSpace*
+VirtMemManager::forkAddrSpace(int parentThreadId, int childThreadId)
+{
+    AddrSpace* parent = getAddrSpaceOfThread(parentThreadId);
+    if (parent == NULL || childThreadId < 0 || virtMemTable->get(childThreadId) != NULL)
+    {
+        return NULL;
+    }
+
+    AddrSpace* child = new AddrSpace(childThreadId, parent);
+    PageTable* childPageTable = child->getPageTable();
+
+    for (int i = 0; i < parent->getNumPages(); i++)
+    {
+        forkPage(parent, child, i);
+    }
+    for (int i = parent->getStackBottomPage(); i < StackTopPage; i++)
+    {
+        forkPage(parent, child, i);
+    }
+
+    //Mmap区域不会被子进程继承，复制页表时带过来的表项要清掉
+    ListIterator<MappedRegion*> regionIter(parent->getMappedRegions());
+    for (; !regionIter.IsDone(); regionIter.Next())
+    {
+        MappedRegion* region = regionIter.Item();
+        for (int i = region->getStartPage(); i < region->getStartPage() + region->getNumPages(); i++)
+        {
+            TranslationEntry* childEntry = childPageTable->lookup(i);
+            if (childEntry != NULL)
+            {
+                childEntry->setValid(FALSE);
+                childPageTable->releaseEntry(i);
+            }
+        }
+    }
+
+    virtMemTable->set(childThreadId, child);
+    child->setSharedText(attachSharedText(child->getFileName(), child->getTextPageNums()));
+
+    return child;
+}
+
+/**
+ * @description: fork时共享父进程的第vpn页：页框增加一个映射者，交换槽增加一个引用，非代码页在双方都变为只读
+ * @param {AddrSpace* parent, AddrSpace* child, int vpn} child的页表已经从parent复制
  * @return: 
  */
 void
-VirtMemManager::deleteAddrSpace(int threadId)
+VirtMemManager::forkPage(AddrSpace* parent, AddrSpace* child, int vpn)
 {
-    if (threadId >= 0 && threadId < virtMemTableSize)
+    //倒排页表中被换出的页没有表项，但子进程已经随页表复制了交换槽，要先增加引用
+    if (child->getSwapSlot(vpn) != -1)
+    {
+        kernel->memoryManager->getSwapManager()->shareSlot(child->getSwapSlot(vpn));
+    }
+
+    TranslationEntry* parentEntry = parent->getPageTable()->lookup(vpn);
+    if (parentEntry == NULL)                    //页表项没有分配，子进程中也没有
+    {
+        return;
+    }
+
+    if (parentEntry->isValid())
     {
-        AddrSpace* entry = virtMemTable[threadId];
-        if (entry != NULL)
+        TranslationEntry* childEntry = child->getPageTable()->lookup(vpn);
+        kernel->memoryManager->getPhyMemManager()->addMapping(parentEntry->getPhysicalPage(), child, vpn, childEntry);
+
+        if (!parent->isTextPage(vpn))
         {
-            TranslationEntry* pageTable = entry->getPageTable();
-            int size = entry->getNumPages();
-            PhyMemManager* PhyManager = kernel->memoryManager->getPhyMemManager();
-            for (int i = 0; i < size; i++)
-            {
-                if (pageTable[i].valid)
-                {
-                    PhyManager->clearOnePage(pageTable[i].physicalPage);
+            //父进程TLB中写命中的脏位在TLB项失效时才写回，复制页表时子进程的表项还没有
+            #ifdef USE_TLB
+            kernel->machine->tlbManager->invalidEntry(parent->getThreadId(), vpn);
+            #endif
+            childEntry->setDirty(parentEntry->isDirty());
+            parentEntry->setReadOnly(TRUE);
+            childEntry->setReadOnly(TRUE);
+        }
+    }
+}
 
-                }
-            }
+/**
+ * @description: 找到可执行文件filename对应的共享代码段，不存在则新建一个
+ * @param {char* filename, int pageNums} 
+ * @return: 共享代码段
+ */
+SharedSegment*
+VirtMemManager::attachSharedText(char* filename, int pageNums)
+{
+    SharedSegment* text = NULL;
+    ListIterator<SharedSegment*> iter(sharedTextList);
 
-            delete entry;
-            virtMemTable[threadId] = NULL;
+    for (; !iter.IsDone(); iter.Next())
+    {
+        if (strcmp(iter.Item()->getName(), filename) == 0 && iter.Item()->getNumPages() == pageNums)
+        {
+            text = iter.Item();
+            break;
         }
     }
+
+    if (text == NULL)
+    {
+        text = new SharedSegment(filename, pageNums);
+        sharedTextList->Append(text);
+    }
+
+    text->attach();
+    return text;
 }
 
-AddrSpace*
-VirtMemManager::getAddrSpaceOfThread(int threadId)
+/**
+ * @description: 解除对共享代码段的映射，最后一个映射者退出时删除该段。
+ *               段内页框的释放由引用计数完成，这里不需要处理
+ * @param {SharedSegment* text} 
+ * @return: 
+ */
+void
+VirtMemManager::detachSharedText(SharedSegment* text)
 {
-    if (threadId >= 0 && threadId < virtMemTableSize)
+    if (text != NULL && text->detach() == 0)
     {
-        return virtMemTable[threadId];
+        sharedTextList->Remove(text);
+        delete text;
     }
-    else
+}
+
+/**
+ * @description: 新建一个名为name的共享内存段，同名的段已经存在时失败
+ * @param {char* name, int pageNums} 
+ * @return: 共享内存段，失败返回NULL
+ */
+SharedSegment*
+VirtMemManager::createSharedMemory(char* name, int pageNums)
+{
+    if (pageNums <= 0 || findSharedMemory(name) != NULL)
     {
         return NULL;
     }
-    
-}
\ No newline at end of file
+
+    SharedSegment* segment = new SharedSegment(name, pageNums);
+    sharedMemList->Append(segment);
+    return segment;
+}
+
+SharedSegment*
+VirtMemManager::findSharedMemory(char* name)
+{
+    ListIterator<SharedSegment*> iter(sharedMemList);
+
+    for (; !iter.IsDone(); iter.Next())
+    {
+        if (strcmp(iter.Item()->getName(), name) == 0)
+        {
+            return iter.Item();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @description: 解除一次挂接，最后一个挂接者离开时删除该段并释放它的交换槽。
+ *               段内的页框在各个映射者解除映射时已经由引用计数释放
+ * @param {SharedSegment* segment} 
+ * @return: 
+ */
+void
+VirtMemManager::detachSharedMemory(SharedSegment* segment)
+{
+    if (segment->detach() == 0)
+    {
+        SwapManager* swapManager = kernel->memoryManager->getSwapManager();
+        for (int i = 0; i < segment->getNumPages(); i++)
+        {
+            if (segment->getSwapSlot(i) != -1)
+            {
+                swapManager->freeSlot(segment->getSwapSlot(i));
+            }
+        }
+
+        sharedMemList->Remove(segment);
+        delete segment;
+    }
+}
+
+/**
+ * @description: 遍历进程的页表，解除该进程对物理页和交换槽的映射(引用计数为0的物理页被清空), 然后删除进程的地址空间
+ * @param {int threadId} 
+ * @return: 
+ */
+void
+VirtMemManager::deleteAddrSpace(int threadId)
+{
+    AddrSpace* entry = virtMemTable->get(threadId);
+
+    if (entry != NULL)
+    {
+        for (int i = 0; i < entry->getNumPages(); i++)
+        {
+            releasePage(entry, i);
+        }
+        for (int i = entry->getStackBottomPage(); i < StackTopPage; i++)
+        {
+            releasePage(entry, i);
+        }
+
+        detachSharedText(entry->getSharedText());
+        delete entry;
+        virtMemTable->remove(threadId);
+    }
+}
+
+/**
+ * @description: 解除地址空间space对第vpn页的页框和交换槽的引用，该页之后再被访问时重新填零
+ * @param {AddrSpace* space, int vpn} 
+ * @return: 
+ */
+void
+VirtMemManager::releasePage(AddrSpace* space, int vpn)
+{
+    PageTable* pageTable = space->getPageTable();
+    TranslationEntry* pageEntry = pageTable->lookup(vpn);
+
+    if (pageEntry != NULL && pageEntry->isValid())
+    {
+        kernel->memoryManager->getPhyMemManager()->removeMapping(pageEntry->getPhysicalPage(), space, vpn);
+        #ifdef USE_TLB
+        kernel->machine->tlbManager->invalidEntry(space->getThreadId(), vpn);
+        #endif
+        pageEntry->setValid(FALSE);
+    }
+    //倒排页表中被换出的页没有表项，交换槽要单独检查
+    if (space->getSwapSlot(vpn) != -1)
+    {
+        kernel->memoryManager->getSwapManager()->freeSlot(space->getSwapSlot(vpn));
+        space->setSwapSlot(vpn, -1);
+    }
+    pageTable->releaseEntry(vpn);
+}
@@ -2,31 +2,45 @@
  * @Author: Lollipop
  * @Date: 2019-11-12 10:31:32
  * @LastEditors: Lollipop
- * @LastEditTime: 2019-11-15 12:04:49
- * @Description: 全局虚存管理器。维护一个virtMemTable数组记录每个进程的AddrSpace指针，进程ID作为数组下标
+ * @LastEditTime: 2019-11-29 14:05:18
+ * @Description: 全局虚存管理器。维护一个virtMemTable表记录每个进程的AddrSpace指针，进程ID作为下标，表随进程号增长
+ *               同时维护一个共享代码段列表，运行同一个可执行文件的地址空间共享同一份只读代码页
+ *               fork出的地址空间与父进程以写时复制的方式共享所有物理页框和交换槽
+ *               另外维护一个按名字查找的共享内存段列表
  */
 #ifndef VIRTMEMMANAGER_H
 #define VIRTMEMMANAGER_H 
 
 #include "addrspace.h"
 #include "translate.h"
-
-#define MAX_VIRT_PAGES 4096
+#include "list.h"
+#include "SharedSegment.h"
+#include "PidTable.h"
 
 class VirtMemManager
 {
 private:
-    int virtPageNums;
-    int virtMemTableSize;
-    AddrSpace** virtMemTable;
+    PidTable<AddrSpace*>* virtMemTable;
+    List<SharedSegment*>* sharedTextList;
+    List<SharedSegment*>* sharedMemList;
+
+    SharedSegment* attachSharedText(char* filename, int pageNums);
+    void detachSharedText(SharedSegment* text);
+    void forkPage(AddrSpace* parent, AddrSpace* child, int vpn);
 public:
-    VirtMemManager(int size);
+    VirtMemManager(int size);           //size是表的初始大小
     ~VirtMemManager();
 
     AddrSpace* createAddrSpace(int mainThreadId, char* filename);
-    AddrSpace* getAddrSpaceOfThread(int threadId);
-    //TODO:shareAddrSpace()
+    AddrSpace* getAddrSpaceOfThread(int threadId) {return virtMemTable->get(threadId);}
+    int getMaxThreadId() {return virtMemTable->getSize();}
+    AddrSpace* forkAddrSpace(int parentThreadId, int childThreadId);
     void deleteAddrSpace(int threadId);
+    void releasePage(AddrSpace* space, int vpn);
+
+    SharedSegment* createSharedMemory(char* name, int pageNums);
+    SharedSegment* findSharedMemory(char* name);
+    void detachSharedMemory(SharedSegment* segment);
 };
 
 #endif	// VIRTMEMMANGER_H
@@ -0,0 +1,311 @@
+// pagesim.cc
+//	Offline page replacement simulator.  Replays a page reference
+//	trace recorded with "nachos -rt <file>" (see machine/ReferenceTrace.h)
+//	against several replacement policies and prints the number of
+//	page faults each one takes for a range of physical memory sizes.
+//
+//	Like the Nachos PhyMemManager, replacement is global: all address
+//	spaces compete for the same frames, and a page is identified by
+//	its (ASID, vpn) pair.  Faults include the compulsory ones.
+//
+//	Policies:
+//	    LRU   -- evict the least recently used page
+//	    Clock -- second chance with a reference bit per frame
+//	    ARC   -- adaptive replacement cache (Megiddo & Modha, 2003)
+//	    OPT   -- Belady's optimal policy, evict the page used farthest
+//	             in the future; a lower bound for every other policy
+//
+//	Usage: pagesim [-f frames,frames,...] [-a asid] tracefile
+//
+//	"-f" gives the frame counts to simulate (default 4, 8, ..., 256);
+//	"-a" keeps only the references of one address space.
+
+#include "ReferenceTrace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+typedef unsigned int Page;		// (ASID << TraceVpnBits) | vpn
+
+static vector<Page> trace;
+
+//----------------------------------------------------------------------
+// ReadTrace
+//	Load the page numbers of every reference in "fileName", keeping
+//	only address space "asid" if it is not -1.
+//----------------------------------------------------------------------
+
+static void
+ReadTrace(char *fileName, int asid)
+{
+    FILE *file = fopen(fileName, "rb");
+    unsigned int magic, record[2];
+
+    if (file == NULL) {
+        perror(fileName);
+        exit(1);
+    }
+    if (fread(&magic, sizeof(magic), 1, file) != 1 || magic != ReferenceTraceMagic) {
+        fprintf(stderr, "%s: not a Nachos reference trace\n", fileName);
+        exit(1);
+    }
+
+    while (fread(record, sizeof(record), 1, file) == 1) {
+        unsigned int word = record[0];
+        if (asid != -1 && (int)(word >> TraceAsidShift) != asid)
+            continue;
+        trace.push_back(((word >> TraceAsidShift) << TraceVpnBits) | (word & TraceVpnMask));
+    }
+    fclose(file);
+}
+
+//----------------------------------------------------------------------
+// SimulateLRU
+//	A list ordered by recency, most recent at the front, plus a map
+//	from page to list position so each reference is O(log n).
+//----------------------------------------------------------------------
+
+static int
+SimulateLRU(int frames)
+{
+    list<Page> recency;
+    map<Page, list<Page>::iterator> resident;
+    int faults = 0;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        map<Page, list<Page>::iterator>::iterator hit = resident.find(trace[i]);
+        if (hit != resident.end()) {
+            recency.erase(hit->second);
+        } else {
+            faults++;
+            if ((int)resident.size() == frames) {
+                resident.erase(recency.back());
+                recency.pop_back();
+            }
+        }
+        recency.push_front(trace[i]);
+        resident[trace[i]] = recency.begin();
+    }
+    return faults;
+}
+
+//----------------------------------------------------------------------
+// SimulateClock
+//	Frames in a circle with a reference bit each.  The hand clears
+//	set bits as it passes and evicts the first page whose bit is clear.
+//----------------------------------------------------------------------
+
+static int
+SimulateClock(int frames)
+{
+    vector<Page> frame(frames);
+    vector<bool> referenced(frames, false);
+    map<Page, int> resident;
+    int used = 0, hand = 0, faults = 0;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        map<Page, int>::iterator hit = resident.find(trace[i]);
+        if (hit != resident.end()) {
+            referenced[hit->second] = true;
+            continue;
+        }
+
+        faults++;
+        int victim;
+        if (used < frames) {
+            victim = used++;
+        } else {
+            while (referenced[hand]) {
+                referenced[hand] = false;
+                hand = (hand + 1) % frames;
+            }
+            victim = hand;
+            hand = (hand + 1) % frames;
+            resident.erase(frame[victim]);
+        }
+        frame[victim] = trace[i];
+        referenced[victim] = true;
+        resident[trace[i]] = victim;
+    }
+    return faults;
+}
+
+//----------------------------------------------------------------------
+// SimulateARC
+//	T1 holds pages seen once recently, T2 pages seen at least twice;
+//	B1 and B2 remember the pages recently evicted from each.  A hit
+//	in B1 (B2) means T1 (T2) was too small, and the target size "p"
+//	of T1 moves accordingly.  Each list keeps its LRU end at the back.
+//----------------------------------------------------------------------
+
+class ArcList {
+  public:
+    list<Page> pages;
+    map<Page, list<Page>::iterator> where;
+
+    bool Contains(Page page) { return where.find(page) != where.end(); }
+    int Size() { return pages.size(); }
+    void PushFront(Page page) { pages.push_front(page); where[page] = pages.begin(); }
+    void Remove(Page page) { pages.erase(where[page]); where.erase(page); }
+    Page PopBack() { Page page = pages.back(); Remove(page); return page; }
+};
+
+static int
+SimulateARC(int frames)
+{
+    ArcList t1, t2, b1, b2;
+    int p = 0, faults = 0;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        Page page = trace[i];
+
+        if (t1.Contains(page) || t2.Contains(page)) {
+            (t1.Contains(page) ? t1 : t2).Remove(page);
+            t2.PushFront(page);
+            continue;
+        }
+
+        faults++;
+        bool inB1 = b1.Contains(page), inB2 = b2.Contains(page);
+        if (inB1) {
+            p = min(frames, p + max(b2.Size() / b1.Size(), 1));
+        } else if (inB2) {
+            p = max(0, p - max(b1.Size() / b2.Size(), 1));
+        }
+
+        if (inB1 || inB2) {
+            (inB1 ? b1 : b2).Remove(page);
+        } else if (t1.Size() + b1.Size() == frames) {
+            if (t1.Size() < frames) {
+                b1.PopBack();
+            } else {		// B1 is empty: drop T1's LRU page outright
+                t1.PopBack();
+            }
+        } else if (t1.Size() + t2.Size() + b1.Size() + b2.Size() >= frames) {
+            if (t1.Size() + t2.Size() + b1.Size() + b2.Size() == 2 * frames) {
+                b2.PopBack();
+            }
+        }
+
+        // Make room in the cache, evicting from T1 or T2 depending on p
+        if (t1.Size() + t2.Size() == frames) {
+            if (t1.Size() > 0 && (t1.Size() > p || (inB2 && t1.Size() == p))) {
+                b1.PushFront(t1.PopBack());
+            } else {
+                b2.PushFront(t2.PopBack());
+            }
+        }
+
+        if (inB1 || inB2) {
+            t2.PushFront(page);
+        } else {
+            t1.PushFront(page);
+        }
+    }
+    return faults;
+}
+
+//----------------------------------------------------------------------
+// SimulateOPT
+//	Precompute, for each reference, when the same page is next used;
+//	on a fault evict the resident page whose next use is farthest away.
+//----------------------------------------------------------------------
+
+static int
+SimulateOPT(int frames)
+{
+    size_t n = trace.size();
+    vector<size_t> nextUse(n);
+    map<Page, size_t> seen;
+    set<pair<size_t, Page> > byNextUse;		// largest next use last
+    map<Page, size_t> resident;		// page -> its entry in byNextUse
+    int faults = 0;
+
+    for (size_t i = n; i-- > 0; ) {
+        map<Page, size_t>::iterator later = seen.find(trace[i]);
+        nextUse[i] = (later == seen.end()) ? n + i : later->second;	// unique "never"
+        seen[trace[i]] = i;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        map<Page, size_t>::iterator hit = resident.find(trace[i]);
+        if (hit != resident.end()) {
+            byNextUse.erase(make_pair(hit->second, trace[i]));
+        } else {
+            faults++;
+            if ((int)resident.size() == frames) {
+                set<pair<size_t, Page> >::iterator victim = --byNextUse.end();
+                resident.erase(victim->second);
+                byNextUse.erase(victim);
+            }
+        }
+        byNextUse.insert(make_pair(nextUse[i], trace[i]));
+        resident[trace[i]] = nextUse[i];
+    }
+    return faults;
+}
+
+//----------------------------------------------------------------------
+// ParseFrames
+//	Turn "8,16,32" into a list of frame counts.
+//----------------------------------------------------------------------
+
+static vector<int>
+ParseFrames(char *arg)
+{
+    vector<int> frames;
+
+    for (char *item = strtok(arg, ","); item != NULL; item = strtok(NULL, ",")) {
+        if (atoi(item) > 0)
+            frames.push_back(atoi(item));
+    }
+    return frames;
+}
+
+int
+main(int argc, char **argv)
+{
+    vector<int> frames;
+    char *fileName = NULL;
+    int asid = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            frames = ParseFrames(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            asid = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && fileName == NULL) {
+            fileName = argv[i];
+        } else {
+            fileName = NULL;
+            break;
+        }
+    }
+    if (fileName == NULL) {
+        fprintf(stderr, "Usage: pagesim [-f frames,frames,...] [-a asid] tracefile\n");
+        return 1;
+    }
+    if (frames.empty()) {
+        for (int f = 4; f <= 256; f *= 2)
+            frames.push_back(f);
+    }
+
+    ReadTrace(fileName, asid);
+    set<Page> distinct(trace.begin(), trace.end());
+    printf("%lu references, %lu distinct pages\n",
+           (unsigned long)trace.size(), (unsigned long)distinct.size());
+
+    printf("%8s %10s %10s %10s %10s\n", "frames", "LRU", "Clock", "ARC", "OPT");
+    for (size_t i = 0; i < frames.size(); i++) {
+        printf("%8d %10d %10d %10d %10d\n", frames[i], SimulateLRU(frames[i]),
+               SimulateClock(frames[i]), SimulateARC(frames[i]), SimulateOPT(frames[i]));
+    }
+    return 0;
+}